@@ -77,12 +77,21 @@ boolean Properties::s_dynamicSummarization = false;
 boolean Properties::s_rangeSync = false;
 boolean Properties::s_allowLrtVrtMismatch = false;
 boolean Properties::s_cardinalityRecalculateRecovery = false;
+boolean Properties::s_secondaryDeferral = false;
 inttype Properties::s_fileRefCheckMod = 0;
 
 boolean Properties::s_seekStatistics = false;
+boolean Properties::s_lockStatistics = false; /* see DEEP_LOCK_STATS */
+boolean Properties::s_latencyStatistics = false; /* see RealTimeLatency, sampled when a map is created */
+String Properties::s_metricsPath = ""; /* see RealTimeMetrics, empty disables export */
 inttype Properties::s_seekStatisticsResetInterval = DEFAULT_CACHE_SEEK_RESET_INTERVAL;
 inttype Properties::s_seekStatisticsDisplayInterval = DEFAULT_CACHE_SEEK_DISPLAY_INTERVAL;
 
+inttype Properties::s_segmentFilterBits = DEFAULT_SEGMENT_FILTER_BITS; /* zero disables segment filters */
+
+inttype Properties::s_hotSetInterval = DEFAULT_FILE_HOT_SET_INTERVAL; /* zero records at unmount only */
+inttype Properties::s_hotSetLimit = DEFAULT_FILE_HOT_SET_LIMIT; /* zero disables hot set prewarm (see O_PREFETCH) */
+
 Properties::CheckpointMode Properties::s_checkpointMode = Properties::CHECKPOINT_AUTO;
 uinttype Properties::s_automaticCheckpointInterval = 900; /* 15 minutes */
 
@@ -81,11 +81,20 @@ class Properties {
 		static boolean s_rangeSync;
 		static boolean s_allowLrtVrtMismatch;
 		static boolean s_cardinalityRecalculateRecovery;
+		static boolean s_secondaryDeferral;
 
 		static boolean s_seekStatistics;
+		static boolean s_lockStatistics;
+		static boolean s_latencyStatistics;
+		static String s_metricsPath;
 		static inttype s_seekStatisticsResetInterval;
 		static inttype s_seekStatisticsDisplayInterval;
 
+		static inttype s_segmentFilterBits;
+
+		static inttype s_hotSetInterval;
+		static inttype s_hotSetLimit;
+
 		static uinttype s_automaticCheckpointInterval;
 		static inttype s_fileRefCheckMod;
 		
@@ -129,9 +138,8 @@ class Properties {
 		static const longtype DEFAULT_CACHE_SIZE = 1073741824L;
 		static const longtype DEFAULT_CACHE_DIVISER = DEFAULT_CACHE_SIZE * 10;
 
-		#ifdef DEEP_IO_STATS
 		static const inttype DEFAULT_CACHE_STATS_MODE = 300 /* 30 seconds */;
-		#endif
+		static const inttype DEFAULT_CACHE_METRICS_MODE = 100 /* 10 seconds */;
 		static const inttype DEFAULT_CACHE_LIMIT_MODE = 600 /* 60 seconds */;
 		static const inttype DEFAULT_CACHE_PURGE_MODE = 150 /* 15 seconds */;
 		static const inttype DEFAULT_CACHE_FSUSAGE_FAST_MODE = 3000 /* 5 minutes */;
@@ -155,6 +163,9 @@ class Properties {
 		static const inttype DEFAULT_FILE_DATA_SIZE = 1073741824;
 		static const inttype DEFAULT_FILE_FETCH_MIN = 67108864;
 		static const inttype DEFAULT_FILE_FETCH_FACTOR = 1;
+		static const inttype DEFAULT_FILE_HOT_SET_INTERVAL = 300000; /* 5 min */
+		static const inttype DEFAULT_FILE_HOT_SET_LIMIT = 65536; /* segments */
+		static const inttype DEFAULT_FILE_HOT_SET_BATCH = 64; /* segments per work cycle */
 		static const inttype DEFAULT_FILE_MIN_REORG_UPTIME = 450000;
 		static const ushorttype DEFAULT_FILE_MAX_REORG_IGNORE = 25;
 		static const inttype DEFAULT_FILE_CLEANUP_INTERVAL = 120; /* 2 min */
@@ -170,6 +181,7 @@ class Properties {
 		static const boolean DEFAULT_TRANSACTION_STREAM = false;
 		static const inttype DEFAULT_TRANSACTION_TIMEOUT = 50000;
 		static const inttype DEFAULT_TRANSACTION_INFINITE = DEFAULT_TRANSACTION_DEPTH / 2;
+		static const inttype DEFAULT_TRANSACTION_STAGING = 1048576; /* values encoded ahead of the stream lock */
 
 		static const inttype DEFAULT_SEGMENT_FILE_RANGE = 8; /* char 8 bits */
 		static const inttype DEFAULT_SEGMENT_LEAF_ORDER = 37;
@@ -183,10 +195,14 @@ class Properties {
 		static const ulongtype DEFAULT_SEGMENT_INDEXING_MIN = 100000;
 		static const ulongtype DEFAULT_SEGMENT_INDEXING_MAX = 1000000;
 		static const inttype DEFAULT_SEGMENT_SUMMARIZATION_LIMIT = 100;
+		static const inttype DEFAULT_SEGMENT_FILTER_BITS = 10; /* per key, ~1% false positives */
 
 		static const inttype DEFAULT_DURABLE_SYNC_INTERVAL = 0;
 		static const inttype DEFAULT_FILE_RANGE_SYNC_CHUNK = 10000000;
 		static const longtype DEFAULT_STATISTICS_FLUSH_INTERVAL = 60; /* 60 seconds */
+		static const inttype DEFAULT_HISTOGRAM_BUCKETS = 256;
+		static const inttype DEFAULT_HISTOGRAM_INTERVAL = 60000; /* 1 minute */
+		static const inttype DEFAULT_HISTOGRAM_DRIFT = 10; /* percent of entries */
 		static const bytetype DEFAULT_VALUE_STATISTIC_PERCENT_REWRITE = 2;
 		static const bytetype DEFAULT_SEGMENT_MINIMUM_KEY_BLOCK_DIVISOR = 2;
 		static const bytetype DEFAULT_MINIMUM_MEMORY_COMPRESSION_KEY = 2;
@@ -584,6 +600,30 @@ class Properties {
 			return s_seekStatistics;
 		}
 
+		FORCE_INLINE static void setLockStatistics(boolean enabled) {
+			s_lockStatistics = enabled;
+		}
+
+		FORCE_INLINE static boolean getLockStatistics(void) {
+			return s_lockStatistics;
+		}
+
+		FORCE_INLINE static void setLatencyStatistics(boolean enabled) {
+			s_latencyStatistics = enabled;
+		}
+
+		FORCE_INLINE static boolean getLatencyStatistics(void) {
+			return s_latencyStatistics;
+		}
+
+		FORCE_INLINE static void setMetricsPath(const char* path) {
+			s_metricsPath = path;
+		}
+
+		FORCE_INLINE static const char* getMetricsPath(void) {
+			return s_metricsPath.data();
+		}
+
 		FORCE_INLINE static void setSeekStatisticsResetInterval(inttype interval) {
 			s_seekStatisticsResetInterval = interval;
 		}
@@ -608,6 +648,30 @@ class Properties {
 			return s_seekStatisticsDisplayInterval / DEFAULT_CACHE_SLEEP;
 		}
 
+		FORCE_INLINE static void setSegmentFilterBits(inttype bits) {
+			s_segmentFilterBits = bits;
+		}
+
+		FORCE_INLINE static inttype getSegmentFilterBits(void) {
+			return s_segmentFilterBits;
+		}
+
+		FORCE_INLINE static void setHotSetInterval(inttype interval) {
+			s_hotSetInterval = interval;
+		}
+
+		FORCE_INLINE static inttype getHotSetInterval(void) {
+			return s_hotSetInterval;
+		}
+
+		FORCE_INLINE static void setHotSetLimit(inttype limit) {
+			s_hotSetLimit = limit;
+		}
+
+		FORCE_INLINE static inttype getHotSetLimit(void) {
+			return s_hotSetLimit;
+		}
+
 		FORCE_INLINE static void setCheckpointMode(CheckpointMode mode) {
 			s_checkpointMode = mode;
 		}
@@ -688,6 +752,14 @@ class Properties {
 			return s_cardinalityRecalculateRecovery;
 		}
 
+		FORCE_INLINE static void setSecondaryDeferral(boolean enabled) {
+			s_secondaryDeferral = enabled;
+		}
+
+		FORCE_INLINE static boolean getSecondaryDeferral(void) {
+			return s_secondaryDeferral;
+		}
+
 		FORCE_INLINE static uinttype getSummaryTarget(void) {
 			return getCheckpointMode() != CHECKPOINT_OFF ? DEFAULT_SUMMARY_TARGET : 0;
 		}
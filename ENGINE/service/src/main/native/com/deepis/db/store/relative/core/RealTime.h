@@ -40,6 +40,8 @@
 #include "com/deepis/db/store/relative/core/Information.h"
 
 #include "com/deepis/db/store/relative/core/RealTimeExtra.h"
+#include "com/deepis/db/store/relative/core/RealTimeLatency.h"
+#include "com/deepis/db/store/relative/core/RealTimeMetrics.h"
 #include "com/deepis/db/store/relative/core/RealTimeShare.h"
 #include "com/deepis/db/store/relative/core/RealTimeLocality.h"
 
@@ -70,6 +72,8 @@ class RealTime : public Synchronizable {
 		static const shorttype O_KEYCOMPRESS = 0x400;
 		static const shorttype O_VALUECOMPRESS = 0x800;
 		static const shorttype O_STATICCONTEXT = 0x1000;
+		static const shorttype O_MEMORYMAP = 0x2000;
+		static const shorttype O_DIRECTWRITE = 0x4000;
 
 		enum ErrorCode {
 			ERR_GENERAL = -1,
@@ -382,6 +386,8 @@ class RealTime : public Synchronizable {
 			#endif
 
 			virtual void seekStatistics(ulongtype* oT, ulongtype* oI, boolean reset) = 0;
+			virtual void filterStatistics(ulongtype* fN, ulongtype* fP, boolean reset) = 0;
+			virtual void metricStatistics(RealTimeMetrics* metrics) = 0;
 
 			virtual longtype findSummaryPaging(MeasuredRandomAccessFile* iwfile, const RealTimeLocality& lastLrtLocality, const uinttype recoveryEpoch) = 0;
 			virtual boolean initSummaryPaging(MeasuredRandomAccessFile* iwfile) = 0;
@@ -400,6 +406,7 @@ class RealTime : public Synchronizable {
 		//
 
 		virtual const ExtraStatistics* getExtraStats(void) = 0;
+		virtual RealTimeLatency* getLatency(void) = 0;
 		virtual const char* getFilePath(void) const = 0;
 		virtual String getDataDirectory(boolean* needsLink = null) const = 0;
 		virtual String getIndexDirectory(boolean* needsLink = null) const = 0;
@@ -554,7 +554,7 @@ struct RealTimeAdaptive_v1 {
 
 					map->m_share.acquire(xwfile);
 					{
-						ExtraStatistics_v1::updateValue(xwfile, &(map->m_extraStats), index, map->m_schemaBuilder->getValueCompression());
+						ExtraStatistics_v2::updateValue(xwfile, &(map->m_extraStats), index, map->m_schemaBuilder->getValueCompression());
 					}
 					map->m_share.release(xwfile);
 				}
@@ -600,7 +600,7 @@ struct RealTimeAdaptive_v1 {
 
 				map->m_share.acquire(xwfile);
 				{
-					ExtraStatistics_v1::updateKey(xwfile, &(map->m_extraStats), index, map->m_schemaBuilder->getKeyName());
+					ExtraStatistics_v2::updateKey(xwfile, &(map->m_extraStats), index, map->m_schemaBuilder->getKeyName());
 				}
 				map->m_share.release(xwfile);
 			}
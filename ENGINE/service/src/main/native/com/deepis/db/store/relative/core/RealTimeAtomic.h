@@ -30,6 +30,7 @@
         
 #include "cxx/io/FileUtil.h"
 #include "cxx/util/TreeMap.h"
+#include "cxx/util/concurrent/locks/FutexLock.h"
 #include "cxx/util/concurrent/locks/UserSpaceLock.h"
 #include "cxx/util/concurrent/atomic/AtomicLong.h"
 #include "com/deepis/db/store/relative/core/Properties.h"
@@ -90,7 +91,7 @@ class RealTimeAtomic {
 		TreeSet<ulongtype>* m_entries;
 		AtomicLong m_sequence;
 		Mode m_mode;
-		UserSpaceLock m_fileLock;	
+		FutexLock m_fileLock;	
 
 	public:
 		MeasuredRandomAccessFile* getFile() {
@@ -31,7 +31,8 @@
 #include "cxx/util/TreeMap.h"
 #include "cxx/util/Converter.h"
 
-#include "cxx/util/concurrent/locks/UserSpaceReadWriteLock.h"
+#include "cxx/util/concurrent/locks/BiasedReadWriteLock.h"
+#include "cxx/util/concurrent/locks/ProfiledLock.h"
 
 #include "com/deepis/db/store/relative/util/ConcurrentObject.h"
 #include "com/deepis/db/store/relative/util/ConcurrentContainer.h"
@@ -304,6 +305,8 @@ class ThreadContext : public ConcurrentObject {
 		}
 };
 
+CXX_LOCK_SITE(ContextLockSite, "context")
+
 template<typename K>
 class RealTimeContext {
 
@@ -311,7 +314,8 @@ class RealTimeContext {
 		const KeyBuilder<K>* m_keyBuilder;
 		ConcurrentContainer<ThreadContext<K>*> m_container;
 
-		UserSpaceReadWriteLock m_lock;
+		// XXX: branch tree readers vastly outnumber writers (split, delete, rekey), keep readers off a shared count
+		CXX_PROFILED_READWRITE_LOCK(BiasedReadWriteLock, ContextLockSite) m_lock;
 
 	public:
 		FORCE_INLINE RealTimeContext(inttype threads, const KeyBuilder<K>* keyBuilder):
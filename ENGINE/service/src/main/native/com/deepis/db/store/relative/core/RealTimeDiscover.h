@@ -97,6 +97,7 @@ class RealTimeDiscover {
 
 					MeasuredRandomAccessFile* vwfile = new MeasuredRandomAccessFile(file, "rw", MapFileUtil::VRT, Properties::DEFAULT_FILE_BUFFER);
 					vwfile->setOptimizeCount(map->m_optimizeStream /* disguise between pre/post optimizing files */);
+					vwfile->setDirectWrite(map->m_directWriteMode);
 					vwfile->setFileIndex(fileIndex);
 					#if 0
 					vwfile->setProtocol(protocol);
@@ -165,6 +166,7 @@ class RealTimeDiscover {
 
 					MeasuredRandomAccessFile* lwfile = new MeasuredRandomAccessFile(file, "rw", MapFileUtil::LRT, Properties::DEFAULT_FILE_BUFFER);
 					lwfile->setOptimizeCount(map->m_optimizeStream /* disguise between pre/post optimizing files */);
+					lwfile->setDirectWrite(map->m_directWriteMode);
 					lwfile->setFileIndex(fileIndex);
 					#if 0
 					lwfile->setProtocol(protocol);
@@ -250,6 +252,7 @@ class RealTimeDiscover {
 					iwfile->setInitialLength(iwfile->length());
 
 					BufferedRandomAccessFile* irfile = new BufferedRandomAccessFile(file, "r", map->m_irtBuffer);
+					irfile->setMemoryMapped(map->m_memoryMapMode);
 					#if 0 
 					irfile->setProtocol(protocol);
 					#else
@@ -480,7 +483,7 @@ class RealTimeDiscover {
 
 					xrfile->syncFilePointer();
 
-					longtype term = ExtraStatistics_v1::validate(xrfile)+1;
+					longtype term = ExtraStatistics_v2::validate(xrfile);
 					// XXX: check if there is a marker, but it is not at the end of the file
 					if ((term < xrfile->length()) && (term > 0)) {
 						DEEP_LOG(WARN, RCVRY, "unterminated xrt: %lld / %lld, %s\n", term, xrfile->length(), map->getFilePath());
@@ -492,7 +495,7 @@ class RealTimeDiscover {
 						share->release(xwfile);
 					}
 					
-					if (ExtraStatistics_v1::read(xrfile, &(map->m_extraStats), map->m_schemaBuilder->getKeyName(), (map->m_primaryIndex == null), map->m_schemaBuilder->getValueCompression()) == false) {
+					if (ExtraStatistics_v2::read(xrfile, &(map->m_extraStats), map->m_schemaBuilder->getKeyName(), (map->m_primaryIndex == null), map->m_schemaBuilder->getValueCompression()) == false) {
 						DEEP_LOG(ERROR, OTHER, "Invalid xrt file, %s\n", map->getFilePath());
 
 						throw InvalidException("Invalid xrt file");
@@ -651,6 +654,17 @@ class RealTimeDiscover {
 			return true;
 		}
 
+		static void directory(const RealTimeMap<K>* map, String& dname, String& sname) {
+			dname = ".";
+			sname = map->getFilePath();
+
+			inttype index = sname.lastIndexOf(File::separator);
+			if (index != -1) {
+				dname = sname.substring(0, index);
+				sname = sname.substring(index + 1, sname.length() - 1);
+			}
+		}
+
 		static boolean statically(RealTimeMap<K>* map, boolean reserve) {
 
 			map->m_hasReservation = reserve;
@@ -661,20 +675,24 @@ class RealTimeDiscover {
 			}
 			*/
 
-			String dname(".");
-			String sname = map->getFilePath();
+			String dname;
+			String sname;
+			directory(map, dname, sname);
+
+			// XXX: a concurrent mount lists and sorts each directory once (see RealTimeMount)
+			ArrayList<String*>* owned = null;
+			const ArrayList<String*>* list = map->m_discoverScan;
+			if (list == null) {
+				owned = File(dname).list();
+				if (owned != null) {
+					Collections::sort(owned);
+				}
 
-			inttype index = sname.lastIndexOf(File::separator);
-			if (index != -1) {
-				dname = sname.substring(0, index);
-				sname = sname.substring(index + 1, sname.length() - 1);
+				list = owned;
 			}
 
-			File directory(dname);
-			ArrayList<String*>* list = File(dname).list();
 			boolean irtInvalid = false;
 			if (list != null) {
-				Collections::sort(list);
 
 				const boolean hotAdd = map->m_dynamic;
 
@@ -742,7 +760,7 @@ class RealTimeDiscover {
 					}
 				}
 
-				delete list;
+				delete owned;
 			}
 
 			map->seedFinalFile();
@@ -28,6 +28,8 @@
 #ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEEXTRA_H_
 #define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEEXTRA_H_
 
+#include <zlib.h>
+
 #include "cxx/lang/String.h"
 #include "cxx/util/HashMap.cxx"
 
@@ -67,6 +69,10 @@ struct ExtraStatistics {
 		// file index -> total value dead entry count
 		HashMap<ushorttype,uinttype> m_valueFragmentationDeadCount;
 
+		// key part -> distinct key count, entry count at time of calculation
+		HashMap<ushorttype,longtype> m_cardinality;
+		longtype m_cardinalityTotal;
+
 	public:
 		ExtraStatistics(void):
 			m_totalChange(false),
@@ -77,7 +83,10 @@ struct ExtraStatistics {
 			m_keyFragmentationTotalCount(INITIAL_CAPACITY, false),
 			m_keyFragmentationDeadCount(INITIAL_CAPACITY, false),
 			m_valueFragmentationTotalCount(INITIAL_CAPACITY, false),
-			m_valueFragmentationDeadCount(INITIAL_CAPACITY, false) {
+			m_valueFragmentationDeadCount(INITIAL_CAPACITY, false),
+
+			m_cardinality(INITIAL_CAPACITY, false),
+			m_cardinalityTotal(0) {
 		}
 
 		FORCE_INLINE boolean getTotalChange() const {
@@ -189,6 +198,27 @@ struct ExtraStatistics {
 		FORCE_INLINE void setKeyFragmentationDeadCount(ushorttype index, uinttype count) {
 			m_keyFragmentationDeadCount.put(index, count);
 		}
+
+		FORCE_INLINE longtype getCardinality(ushorttype part) const {
+			if (m_cardinality.containsKey(part) == true) {
+				return m_cardinality.get(part);
+
+			} else {
+				return 0;
+			}
+		}
+
+		FORCE_INLINE void setCardinality(ushorttype part, longtype count) {
+			m_cardinality.put(part, count);
+		}
+
+		FORCE_INLINE longtype getCardinalityTotal() const {
+			return m_cardinalityTotal;
+		}
+
+		FORCE_INLINE void setCardinalityTotal(longtype total) {
+			m_cardinalityTotal = total;
+		}
 };
 
 struct FragmentationStatistics_v1 {
@@ -363,6 +393,15 @@ struct ExtraStatistics_v1 {
 	public:
 		static boolean read(RandomAccessFile* xrfile, ExtraStatistics* extra, const char* keyName, boolean primary, boolean compressed) {
 			org::w3c::dom::Document* doc = org::w3c::dom::DomUtil::readFile(xrfile);
+
+			read(doc, extra, keyName, primary, compressed);
+
+			delete doc;
+
+			return true;
+		}
+
+		static void read(org::w3c::dom::Document* doc, ExtraStatistics* extra, const char* keyName, boolean primary, boolean compressed) {
 			org::w3c::dom::Element statsElem;
 
 			// TODO: use getLastChild / getPreviousSibling optimization
@@ -384,10 +423,6 @@ struct ExtraStatistics_v1 {
 				}
 
 			} while (statsElem.getNextSibling(&statsElem) != null);
-
-			delete doc;
-
-			return true;
 		}
 
 		static void updateKey(RandomAccessFile* xwfile, ExtraStatistics* extra, ushorttype fileIndex, const char* keyName) {
@@ -497,6 +532,299 @@ struct ExtraStatistics_v1 {
 		}
 };
 
+// XXX: fixed-layout checksummed records (one pwrite per update, mapped on read), legacy xml statistics remain readable
+struct ExtraStatistics_v2 {
+	public:
+		static const uinttype MAGIC = 0x54525844; /* DXRT */
+		static const ubytetype FORMAT = 2;
+
+		enum RecordType {
+			RECORD_VERSION = 1,
+			RECORD_VALUE = 2,
+			RECORD_KEY = 3,
+			RECORD_SIZE = 4,
+			RECORD_CARDINALITY = 5
+		};
+
+		struct Record {
+			uinttype m_magic;
+			ubytetype m_format;
+			ubytetype m_type;
+			ushorttype m_fileIndex;
+
+			uinttype m_keyHash;
+			uinttype m_deadCount;
+			uinttype m_totalCount;
+
+			bytetype m_compressionPercentage;
+			ubytetype m_compressionQualified;
+			ubytetype m_compressed;
+			ubytetype m_reserved;
+
+			longtype m_total; /* protocol for RECORD_VERSION, distinct keys for RECORD_CARDINALITY */
+			longtype m_userSpace; /* entries for RECORD_CARDINALITY */
+			longtype m_timestamp;
+
+			uinttype m_padding;
+			uinttype m_checksum;
+		};
+
+	public:
+		static boolean read(RandomAccessFile* xrfile, ExtraStatistics* extra, const char* keyName, boolean primary, boolean compressed) {
+			// XXX: length may have been truncated by validation through the writer
+			xrfile->syncFilePointer();
+
+			longtype length = xrfile->length();
+			if (length == 0) {
+				return true;
+			}
+
+			voidarray address = xrfile->getFD()->map(length);
+			{
+				scan((const bytearray) address, length, extra, keyName, primary, compressed);
+			}
+			FileDescriptor::unmap(address, length);
+
+			return true;
+		}
+
+		static void updateKey(RandomAccessFile* xwfile, ExtraStatistics* extra, ushorttype fileIndex, const char* keyName) {
+			Record record;
+			initialize(&record, RECORD_KEY, fileIndex);
+
+			record.m_keyHash = hash(keyName);
+			record.m_deadCount = extra->getKeyFragmentationDeadCount(fileIndex);
+			record.m_totalCount = extra->getKeyFragmentationTotalCount(fileIndex);
+
+			terminate(xwfile, &record);
+		}
+
+		static void updateValue(RandomAccessFile* xwfile, ExtraStatistics* extra, ushorttype fileIndex, boolean compressed) {
+			Record record;
+			initialize(&record, RECORD_VALUE, fileIndex);
+
+			record.m_compressed = (compressed == true);
+			if (compressed == true) {
+				record.m_compressionPercentage = extra->getCompressionPercentage(fileIndex);
+				record.m_compressionQualified = extra->getCompressionQualified(fileIndex);
+			}
+
+			record.m_deadCount = extra->getValueFragmentationDeadCount(fileIndex);
+			record.m_totalCount = extra->getValueFragmentationTotalCount(fileIndex);
+
+			terminate(xwfile, &record);
+		}
+
+		static void updateSize(RandomAccessFile* xwfile, ExtraStatistics* extra, boolean force = false) {
+			if ((extra->getTotalChange() == true) || (force == true)) {
+				Record record;
+				initialize(&record, RECORD_SIZE, 0);
+
+				record.m_total = extra->getTotalSize();
+				record.m_userSpace = extra->getUserSpaceSize();
+				record.m_timestamp = System::currentTimeMillis();
+
+				terminate(xwfile, &record);
+
+				if (force == false) {
+					extra->setTotalChange(false);
+				}
+			}
+		}
+
+		// XXX: one record per key part (i.e. m_fileIndex is the key part)
+		static void updateCardinality(RandomAccessFile* xwfile, ExtraStatistics* extra, uinttype keyParts, const char* keyName) {
+			for (uinttype i = 0; i < keyParts; i++) {
+				Record record;
+				initialize(&record, RECORD_CARDINALITY, i);
+
+				record.m_keyHash = hash(keyName);
+				record.m_total = extra->getCardinality(i);
+				record.m_userSpace = extra->getCardinalityTotal();
+				record.m_timestamp = System::currentTimeMillis();
+
+				terminate(xwfile, &record);
+			}
+		}
+
+		static void version(RandomAccessFile* xwfile) {
+			Record record;
+			initialize(&record, RECORD_VERSION, 0);
+
+			record.m_total = Versions::getProtocolVersion();
+			record.m_timestamp = System::currentTimeMillis();
+
+			terminate(xwfile, &record);
+		}
+
+		// XXX: returns the length of the valid (i.e. fully terminated) prefix of the file
+		static longtype validate(RandomAccessFile* xrfile) {
+			longtype length = xrfile->length();
+			if (length == 0) {
+				return 0;
+			}
+
+			longtype valid = 0;
+
+			voidarray address = xrfile->getFD()->map(length);
+			{
+				valid = scan((const bytearray) address, length, null, null, false, false);
+			}
+			FileDescriptor::unmap(address, length);
+
+			return valid;
+		}
+
+	private:
+		FORCE_INLINE static uinttype hash(const char* keyName) {
+			// XXX: FNV-1a, key names are only compared against the secondaries of one primary
+			uinttype value = 2166136261U;
+			for (const char* c = keyName; *c != '\0'; c++) {
+				value = (value ^ (ubytetype) *c) * 16777619U;
+			}
+
+			return value;
+		}
+
+		FORCE_INLINE static uinttype checksum(const Record* record) {
+			return crc32(0L, (const Bytef*) record, (uInt) (sizeof(Record) - sizeof(uinttype)));
+		}
+
+		FORCE_INLINE static void initialize(Record* record, RecordType type, ushorttype fileIndex) {
+			memset(record, 0, sizeof(Record));
+
+			record->m_magic = MAGIC;
+			record->m_format = FORMAT;
+			record->m_type = type;
+			record->m_fileIndex = fileIndex;
+		}
+
+		static void terminate(RandomAccessFile* xwfile, Record* record) {
+			record->m_checksum = checksum(record);
+
+			nbyte bytes((const voidarray) record, sizeof(Record));
+			xwfile->positionalWrite(&bytes, 0, sizeof(Record), xwfile->length());
+		}
+
+		static void apply(const Record* record, ExtraStatistics* extra, const char* keyName, boolean primary, boolean compressed) {
+			switch (record->m_type) {
+				case RECORD_VALUE:
+					if (primary == false) {
+						break;
+					}
+
+					if ((compressed == true) && (record->m_compressed != 0)) {
+						extra->setCompressionPercentage(record->m_fileIndex, record->m_compressionPercentage);
+						extra->setCompressionQualified(record->m_fileIndex, (record->m_compressionQualified != 0));
+					}
+
+					extra->setValueFragmentationDeadCount(record->m_fileIndex, record->m_deadCount);
+					extra->setValueFragmentationTotalCount(record->m_fileIndex, record->m_totalCount);
+					break;
+
+				case RECORD_KEY:
+					if (record->m_keyHash != hash(keyName)) {
+						break;
+					}
+
+					extra->setKeyFragmentationDeadCount(record->m_fileIndex, record->m_deadCount);
+					extra->setKeyFragmentationTotalCount(record->m_fileIndex, record->m_totalCount);
+					break;
+
+				case RECORD_SIZE:
+					extra->setTotalSize(record->m_total);
+					extra->setUserSpaceSize(record->m_userSpace);
+
+					extra->setTotalChange(false);
+					break;
+
+				case RECORD_CARDINALITY:
+					if (record->m_keyHash != hash(keyName)) {
+						break;
+					}
+
+					extra->setCardinality(record->m_fileIndex, record->m_total);
+					extra->setCardinalityTotal(record->m_userSpace);
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		// XXX: end of a run of legacy (xml) documents, each terminated by a mark element, or -1 if unterminated
+		static longtype legacy(const bytearray base, longtype pos, longtype length) {
+			static const char marker[] = "<mark/>\n";
+			static const inttype size = sizeof(marker) - 1;
+
+			longtype end = -1;
+			while (pos < length) {
+				const bytearray match = (const bytearray) memmem(base + pos, length - pos, marker, size);
+				if (match == null) {
+					break;
+				}
+
+				end = pos = (match - base) + size;
+
+				// XXX: binary records can be appended to a legacy file
+				if ((pos < length) && (base[pos] != '<')) {
+					break;
+				}
+			}
+
+			return end;
+		}
+
+		static longtype scan(const bytearray base, longtype length, ExtraStatistics* extra, const char* keyName, boolean primary, boolean compressed) {
+			longtype pos = 0;
+			while (pos < length) {
+				uinttype magic = 0;
+				if ((length - pos) >= (longtype) sizeof(magic)) {
+					memcpy(&magic, base + pos, sizeof(magic));
+				}
+
+				if (magic == MAGIC) {
+					if ((length - pos) < (longtype) sizeof(Record)) {
+						break;
+					}
+
+					Record record;
+					memcpy(&record, base + pos, sizeof(Record));
+
+					if ((record.m_format != FORMAT) || (record.m_checksum != checksum(&record))) {
+						break;
+					}
+
+					if (extra != null) {
+						apply(&record, extra, keyName, primary, compressed);
+					}
+
+					pos += sizeof(Record);
+
+				} else {
+					longtype end = legacy(base, pos, length);
+					if (end == -1) {
+						break;
+					}
+
+					if (extra != null) {
+						String xml(base + pos, end - pos);
+
+						org::w3c::dom::Document* doc = org::w3c::dom::DomUtil::parse(xml.data());
+						{
+							ExtraStatistics_v1::read(doc, extra, keyName, primary, compressed);
+						}
+						delete doc;
+					}
+
+					pos = end;
+				}
+			}
+
+			return pos;
+		}
+};
+
 const String FragmentationStatistics_v1::DEAD_COUNT       = "dead_count";
 const String FragmentationStatistics_v1::TOTAL_COUNT      = "total_count";
 const String FragmentationStatistics_v1::FRAGMENTATION    = "fragmentation";
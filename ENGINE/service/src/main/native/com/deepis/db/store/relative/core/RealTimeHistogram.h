@@ -0,0 +1,405 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEHISTOGRAM_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEHISTOGRAM_H_
+
+#include "cxx/util/TreeMap.h"
+#include "cxx/util/concurrent/locks/UserSpaceReadWriteLock.h"
+
+#include "com/deepis/db/store/relative/core/Segment.h"
+#include "com/deepis/db/store/relative/core/Properties.h"
+#include "com/deepis/db/store/relative/core/RealTimeExtra.h"
+#include "com/deepis/db/store/relative/core/RealTimeBuilder.h"
+#include "com/deepis/db/store/relative/core/RealTimeConverter.h"
+
+using namespace cxx::util;
+using namespace cxx::util::concurrent::locks;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: equi-depth histogram over the branch tree (i.e. bucket boundaries are segment first keys, depth is segment vsize)
+template<typename K>
+class RealTimeHistogram {
+
+	typedef typename TreeMap<K,Segment<K>*>::TreeMapEntrySet::EntrySetIterator MapSegmentEntrySetIterator;
+
+	private:
+		const Comparator<K>* m_comparator;
+		const KeyBuilder<K>* m_keyBuilder;
+
+		inttype m_size;
+		K* m_lowerKeys;
+		longtype* m_cumulative; /* m_size + 1 entries, last is total */
+		boolean* m_summarized;
+
+		longtype m_total;
+		longtype m_timestamp;
+		longtype m_persisted;
+
+		longtype m_cardinalityTotal;
+		longtype m_cardinality[Properties::FIXED_KEY_PARTS];
+
+		mutable UserSpaceReadWriteLock m_lock;
+
+	private:
+		FORCE_INLINE inttype bucket(K key) const {
+			inttype found = -1;
+
+			inttype lo = 0;
+			inttype hi = m_size - 1;
+			while (lo <= hi) {
+				inttype mid = (lo + hi) >> 1;
+				if (m_comparator->compare(m_lowerKeys[mid], key) <= 0) {
+					found = mid;
+					lo = mid + 1;
+
+				} else {
+					hi = mid - 1;
+				}
+			}
+
+			return found;
+		}
+
+		FORCE_INLINE longtype rank(K key, inttype index) const {
+			if (index == -1) {
+				return 0;
+			}
+
+			// XXX: position within a bucket is unknown, assume the middle (i.e. error is bounded by half the bucket depth)
+			if (m_comparator->compare(m_lowerKeys[index], key) == 0) {
+				return m_cumulative[index];
+			}
+
+			return m_cumulative[index] + ((m_cumulative[index + 1] - m_cumulative[index]) / 2);
+		}
+
+		FORCE_INLINE static longtype scale(longtype value, longtype total, longtype entries) {
+			if ((total <= 0) || (entries <= 0) || (total == entries)) {
+				return value;
+			}
+
+			return (longtype) (((doubletype) value) * (((doubletype) entries) / ((doubletype) total)));
+		}
+
+		FORCE_INLINE void destroy(inttype size, K* lowerKeys, longtype* cumulative, boolean* summarized) {
+			for (inttype i = 0; i < size; i++) {
+				Converter<K>::destroy(lowerKeys[i]);
+			}
+
+			delete [] lowerKeys;
+			delete [] cumulative;
+			delete [] summarized;
+		}
+
+	public:
+		RealTimeHistogram(const Comparator<K>* comparator, const KeyBuilder<K>* keyBuilder) :
+			m_comparator(comparator),
+			m_keyBuilder(keyBuilder),
+			m_size(0),
+			m_lowerKeys(null),
+			m_cumulative(null),
+			m_summarized(null),
+			m_total(0),
+			m_timestamp(0),
+			m_persisted(0),
+			m_cardinalityTotal(0) {
+
+			memset(m_cardinality, 0, sizeof(m_cardinality));
+		}
+
+		~RealTimeHistogram() {
+			destroy(m_size, m_lowerKeys, m_cumulative, m_summarized);
+		}
+
+		FORCE_INLINE longtype getTotal(void) const {
+			return m_total;
+		}
+
+		FORCE_INLINE longtype getTimestamp(void) const {
+			return m_timestamp;
+		}
+
+		FORCE_INLINE boolean stale(longtype entries, longtype now) const {
+			if (m_timestamp == 0) {
+				return true;
+			}
+
+			longtype elapsed = now - m_timestamp;
+			if (elapsed < Properties::DEFAULT_HISTOGRAM_INTERVAL) {
+				return false;
+			}
+
+			if (elapsed > (Properties::getStatisticsFlushInterval() * 1000)) {
+				return true;
+			}
+
+			longtype drift = (entries > m_total) ? (entries - m_total) : (m_total - entries);
+			return (drift * 100) > (m_total * Properties::DEFAULT_HISTOGRAM_DRIFT);
+		}
+
+		FORCE_INLINE boolean persist(longtype now) {
+			if ((now - m_persisted) < (Properties::getStatisticsFlushInterval() * 1000)) {
+				return false;
+			}
+
+			m_persisted = now;
+			return true;
+		}
+
+		// XXX: caller holds the branch tree read lock
+		void build(TreeMap<K,Segment<K>*>* branchSegmentTreeMap, inttype buckets, longtype now) {
+
+			inttype size = 0;
+			K* lowerKeys = null;
+			longtype* cumulative = null;
+			boolean* summarized = null;
+
+			longtype total = 0;
+			longtype cardinality[Properties::FIXED_KEY_PARTS];
+			memset(cardinality, 0, sizeof(cardinality));
+
+			const uinttype keyParts = m_keyBuilder->getKeyParts();
+
+			if (branchSegmentTreeMap->TreeMap<K,Segment<K>*>::size() != 0) {
+				typename TreeMap<K,Segment<K>*>::TreeMapEntrySet stackSegmentSet(true);
+				branchSegmentTreeMap->entrySet(&stackSegmentSet);
+
+				MapSegmentEntrySetIterator* segIter = (MapSegmentEntrySetIterator*) stackSegmentSet.reset();
+				while (segIter->MapSegmentEntrySetIterator::hasNext()) {
+					total += segIter->MapSegmentEntrySetIterator::next()->getValue()->vsize();
+				}
+
+				const longtype depth = (total / buckets) + 1;
+
+				lowerKeys = new K[buckets];
+				cumulative = new longtype[buckets + 1];
+				summarized = new boolean[buckets];
+
+				longtype running = 0;
+				longtype filled = 0;
+
+				K lastKey = (K) Converter<K>::NULL_VALUE;
+
+				segIter = (MapSegmentEntrySetIterator*) stackSegmentSet.reset();
+				while (segIter->MapSegmentEntrySetIterator::hasNext()) {
+					MapEntry<K,Segment<K>*>* segEntry = segIter->MapSegmentEntrySetIterator::next();
+					Segment<K>* segment = segEntry->getValue();
+
+					// XXX: summary segments contribute their collapsed size (i.e. no need to fill them)
+					if ((size == 0) || ((filled >= depth) && (size < buckets))) {
+						lowerKeys[size] = m_keyBuilder->cloneKey(segEntry->getKey());
+						cumulative[size] = running;
+						summarized[size] = false;
+
+						filled = 0;
+						size++;
+					}
+
+					filled += segment->vsize();
+					running += segment->vsize();
+
+					if (segment->getSummary() == true) {
+						summarized[size - 1] = true;
+					}
+
+					// XXX: key parts of "one" means cardinality is equal to the number of rows (see RealTimeMap::cardinality)
+					if ((keyParts == 1) || (segment->getCardinality() == null)) {
+						cardinality[0] += segment->vsize();
+						continue;
+					}
+
+					for (uinttype i = 0; i < keyParts; i++) {
+						cardinality[i] += segment->getCardinality()[i];
+					}
+
+					#ifdef COM_DEEPIS_DB_CARDINALITY
+					// XXX: adjust for overlap
+					if (lastKey != (K) Converter<K>::NULL_VALUE) {
+						inttype pos = 0;
+						m_comparator->compare(lastKey, segEntry->getKey(), &pos);
+
+						if (pos > 0) {
+							cardinality[0]--;
+							cardinality[pos]++;
+						}
+					}
+					#endif
+
+					lastKey = segEntry->getKey();
+				}
+
+				cumulative[size] = running;
+			}
+
+			m_lock.writeLock();
+			{
+				inttype oldSize = m_size;
+				K* oldLowerKeys = m_lowerKeys;
+				longtype* oldCumulative = m_cumulative;
+				boolean* oldSummarized = m_summarized;
+
+				m_size = size;
+				m_lowerKeys = lowerKeys;
+				m_cumulative = cumulative;
+				m_summarized = summarized;
+
+				m_total = total;
+				m_timestamp = now;
+
+				// XXX: keep seeded cardinality when resident segments do not carry theirs (e.g. right after mount)
+				if ((keyParts == 1) || (cardinality[keyParts - 1] != 0) || (m_cardinalityTotal == 0)) {
+					m_cardinalityTotal = total;
+					memcpy(m_cardinality, cardinality, sizeof(m_cardinality));
+				}
+
+				size = oldSize;
+				lowerKeys = oldLowerKeys;
+				cumulative = oldCumulative;
+				summarized = oldSummarized;
+			}
+			m_lock.writeUnlock();
+
+			destroy(size, lowerKeys, cumulative, summarized);
+		}
+
+		// XXX: seed cardinality from persisted statistics, buckets are rebuilt from the branch tree
+		void seed(const ExtraStatistics* extra, longtype now) {
+			if (extra->getCardinalityTotal() <= 0) {
+				return;
+			}
+
+			m_lock.writeLock();
+			{
+				m_persisted = now;
+
+				m_cardinalityTotal = extra->getCardinalityTotal();
+				for (uinttype i = 0; i < m_keyBuilder->getKeyParts(); i++) {
+					m_cardinality[i] = extra->getCardinality(i);
+				}
+			}
+			m_lock.writeUnlock();
+		}
+
+		void store(ExtraStatistics* extra) const {
+			m_lock.readLock();
+			{
+				extra->setCardinalityTotal(m_cardinalityTotal);
+				for (uinttype i = 0; i < m_keyBuilder->getKeyParts(); i++) {
+					extra->setCardinality(i, m_cardinality[i]);
+				}
+			}
+			m_lock.readUnlock();
+		}
+
+		void clear(void) {
+			m_lock.writeLock();
+			{
+				destroy(m_size, m_lowerKeys, m_cumulative, m_summarized);
+
+				m_size = 0;
+				m_lowerKeys = null;
+				m_cumulative = null;
+				m_summarized = null;
+
+				m_total = 0;
+				m_timestamp = 0;
+				m_persisted = 0;
+
+				m_cardinalityTotal = 0;
+				memset(m_cardinality, 0, sizeof(m_cardinality));
+			}
+			m_lock.writeUnlock();
+		}
+
+		// XXX: returns false when both keys fall into one resident bucket (i.e. caller can afford to walk its segments)
+		boolean range(const K* skey, const K* ekey, longtype entries, longtype* estimate) const {
+			boolean answered = false;
+
+			m_lock.readLock();
+			{
+				if (m_size != 0) {
+					inttype sindex = (skey != null) ? bucket(*skey) : -1;
+					inttype eindex = (ekey != null) ? bucket(*ekey) : m_size - 1;
+
+					if ((skey != null) && (ekey != null) && (sindex == eindex)) {
+						if ((sindex != -1) && (m_summarized[sindex] == true)) {
+							*estimate = (m_cumulative[sindex + 1] - m_cumulative[sindex]) / 2;
+							answered = true;
+						}
+
+					} else {
+						longtype srank = (skey != null) ? rank(*skey, sindex) : 0;
+						longtype erank = (ekey != null) ? rank(*ekey, eindex) : m_cumulative[m_size];
+
+						*estimate = (erank > srank) ? (erank - srank) : 0;
+						answered = true;
+					}
+
+					if (answered == true) {
+						*estimate = scale(*estimate, m_total, entries);
+
+						// XXX: planners treat zero as an empty range, never claim that from an estimate
+						if ((*estimate == 0) && (entries > 0)) {
+							*estimate = 1;
+						}
+					}
+				}
+			}
+			m_lock.readUnlock();
+
+			return answered;
+		}
+
+		boolean cardinality(longtype* stats, longtype entries) const {
+			boolean answered = false;
+
+			m_lock.readLock();
+			{
+				if (m_cardinalityTotal > 0) {
+					for (uinttype i = 0; i < m_keyBuilder->getKeyParts(); i++) {
+						longtype stat = scale(m_cardinality[i], m_cardinalityTotal, entries);
+						if ((entries > 0) && (stat > entries)) {
+							stat = entries;
+						}
+
+						stats[i] += stat;
+					}
+
+					answered = true;
+				}
+			}
+			m_lock.readUnlock();
+
+			return answered;
+		}
+};
+
+} } } } } } // namespace
+
+#endif /* COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEHISTOGRAM_H_ */
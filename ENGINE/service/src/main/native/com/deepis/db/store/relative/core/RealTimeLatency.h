@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMELATENCY_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMELATENCY_H_
+
+#include <time.h>
+#include <pthread.h>
+
+#include "cxx/lang/types.h"
+
+using namespace cxx::lang;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: per map operation latency histograms (i.e. hdr style log-linear buckets), recorded in tsc ticks and reported in nanoseconds
+class RealTimeLatency {
+
+	public:
+		enum Operation {
+			GET = 0,
+			GET_NEXT,
+			PUT,
+			REMOVE,
+			COMMIT,
+			FILL,
+			INDEX,
+			PURGE,
+			SYNC,
+			OPERATIONS
+		};
+
+		// XXX: records the scope of an operation (no-op when latency statistics are disabled for the map)
+		class Timer {
+
+			private:
+				RealTimeLatency* m_latency;
+				Operation m_operation;
+				ulongtype m_start;
+
+			public:
+				FORCE_INLINE Timer(RealTimeLatency* latency, Operation operation):
+					m_latency(latency),
+					m_operation(operation),
+					m_start((latency != null) ? ticks() : 0) {
+				}
+
+				FORCE_INLINE ~Timer(void) {
+					if (m_latency != null) {
+						m_latency->record(m_operation, ticks() - m_start);
+					}
+				}
+		};
+
+	private:
+		// XXX: 2^SUB_BITS linear sub-buckets per power of two (i.e. within 25% of the true value)
+		static const uinttype SUB_BITS = 2;
+		static const uinttype SUB_BUCKETS = 1 << SUB_BITS;
+		static const uinttype MAX_EXPONENT = 47;
+		static const uinttype BUCKETS = (MAX_EXPONENT - SUB_BITS + 2) * SUB_BUCKETS;
+
+		// XXX: threads record into one of these by thread hash, readers merge all of them (i.e. no shared line per operation)
+		static const uinttype SHARDS = 8;
+
+		struct Shard {
+			uinttype m_counts[OPERATIONS][BUCKETS];
+		} __attribute__((aligned(64)));
+
+		Shard m_shards[SHARDS];
+
+		FORCE_INLINE static uinttype bucket(ulongtype value) {
+			if (value < SUB_BUCKETS) {
+				return (uinttype) value;
+			}
+
+			uinttype exponent = 63 - __builtin_clzll(value);
+			if (exponent > MAX_EXPONENT) {
+				return BUCKETS - 1;
+			}
+
+			const uinttype sub = (uinttype) (value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1);
+			return ((exponent - SUB_BITS + 1) * SUB_BUCKETS) + sub;
+		}
+
+		// XXX: upper bound of a bucket (i.e. percentiles are reported conservatively)
+		FORCE_INLINE static ulongtype value(uinttype index) {
+			if (index < SUB_BUCKETS) {
+				return index;
+			}
+
+			const uinttype exponent = (index / SUB_BUCKETS) + SUB_BITS - 1;
+			const ulongtype sub = index % SUB_BUCKETS;
+
+			return ((SUB_BUCKETS + sub + 1) << (exponent - SUB_BITS)) - 1;
+		}
+
+		FORCE_INLINE static uinttype shard(void) {
+			const ulongtype hash = ((ulongtype) pthread_self()) * 0x9e3779b97f4a7c15ULL;
+
+			return (uinttype) (hash >> 32) % SHARDS;
+		}
+
+		FORCE_INLINE static ulongtype nanoTime(void) {
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			return (((ulongtype) ts.tv_sec) * 1000000000ULL) + ts.tv_nsec;
+		}
+
+		// XXX: calibrated once against the monotonic clock (benign race on first use)
+		FORCE_INLINE static double ticksPerNano(void) {
+			static double s_ticksPerNano = 0;
+
+			if (s_ticksPerNano == 0) {
+				const ulongtype nanos = nanoTime();
+				const ulongtype start = ticks();
+
+				ulongtype elapsed = 0;
+				do {
+					elapsed = nanoTime() - nanos;
+				} while (elapsed < 5000000 /* 5 ms */);
+
+				s_ticksPerNano = ((double) (ticks() - start)) / elapsed;
+			}
+
+			return s_ticksPerNano;
+		}
+
+	public:
+		RealTimeLatency(void) {
+			reset();
+			ticksPerNano();
+		}
+
+		FORCE_INLINE static ulongtype ticks(void) {
+			return __builtin_ia32_rdtsc();
+		}
+
+		FORCE_INLINE static const char* getName(Operation operation) {
+			static const char* s_names[OPERATIONS] = { "get", "getNext", "put", "remove", "commit", "fill", "index", "purge", "sync" };
+
+			return s_names[operation];
+		}
+
+		FORCE_INLINE void record(Operation operation, ulongtype ticks) {
+			__sync_add_and_fetch(&m_shards[shard()].m_counts[operation][bucket(ticks)], 1);
+		}
+
+		ulongtype getCount(Operation operation) const {
+			ulongtype count = 0;
+			for (uinttype s = 0; s < SHARDS; s++) {
+				for (uinttype i = 0; i < BUCKETS; i++) {
+					count += m_shards[s].m_counts[operation][i];
+				}
+			}
+
+			return count;
+		}
+
+		// XXX: p in (0, 1], e.g. 0.5, 0.99, 0.999
+		ulongtype getPercentile(Operation operation, double p) const {
+			ulongtype merged[BUCKETS];
+			ulongtype count = 0;
+
+			for (uinttype i = 0; i < BUCKETS; i++) {
+				merged[i] = 0;
+				for (uinttype s = 0; s < SHARDS; s++) {
+					merged[i] += m_shards[s].m_counts[operation][i];
+				}
+
+				count += merged[i];
+			}
+
+			if (count == 0) {
+				return 0;
+			}
+
+			const ulongtype rank = (ulongtype) (count * p);
+			ulongtype seen = 0;
+			for (uinttype i = 0; i < BUCKETS; i++) {
+				seen += merged[i];
+				if (seen > rank) {
+					return (ulongtype) (value(i) / ticksPerNano());
+				}
+			}
+
+			return (ulongtype) (value(BUCKETS - 1) / ticksPerNano());
+		}
+
+		void reset(void) {
+			for (uinttype s = 0; s < SHARDS; s++) {
+				for (uinttype o = 0; o < OPERATIONS; o++) {
+					for (uinttype i = 0; i < BUCKETS; i++) {
+						m_shards[s].m_counts[o][i] = 0;
+					}
+				}
+			}
+		}
+};
+
+} } } } } } // namespace
+
+#endif /*COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMELATENCY_H_*/
@@ -54,6 +54,8 @@
 #include "com/deepis/db/store/relative/core/RealTimeVersion.h"
 #include "com/deepis/db/store/relative/core/RealTimeAdaptive.h"
 #include "com/deepis/db/store/relative/core/RealTimeRecovery.h"
+#include "com/deepis/db/store/relative/core/RealTimeMount.h"
+#include "com/deepis/db/store/relative/core/RealTimeWriteBatch.h"
 
 /* XXX: Code legends (Information parameter meaning)
  *
@@ -104,6 +106,8 @@ RealTimeMap<K>::RealTimeMap(const char* filepath, const longtype options, const
 	m_singularMode((m_share.getOptions() & O_SINGULAR) == O_SINGULAR),
 	m_prefetchMode((m_share.getOptions() & O_PREFETCH) == O_PREFETCH),
 	m_rowStoreMode((m_share.getOptions() & O_ROWSTORE) == O_ROWSTORE),
+	m_memoryMapMode((m_share.getOptions() & O_MEMORYMAP) == O_MEMORYMAP),
+	m_directWriteMode((m_share.getOptions() & O_DIRECTWRITE) == O_DIRECTWRITE),
 
 	m_keyCompressMode((m_share.getOptions() & O_KEYCOMPRESS) == O_KEYCOMPRESS),
 	m_valueCompressMode((m_share.getOptions() & O_VALUECOMPRESS) == O_VALUECOMPRESS),
@@ -126,6 +130,7 @@ RealTimeMap<K>::RealTimeMap(const char* filepath, const longtype options, const
 	m_threadIndexing(false),
 	m_hasReservation(false),
 	m_hasSecondaryMaps(false),
+	m_discoverScan(null),
 
 	m_irtBuildReorganization(false),
 	m_irtForceReorganization(false),
@@ -141,17 +146,24 @@ RealTimeMap<K>::RealTimeMap(const char* filepath, const longtype options, const
 
 	m_deletedSegmentList(Properties::LIST_CAP, true),
 	m_orderSegmentCmp(m_comparator),
-	m_orderSegmentList((const PriorityQueue<Segment<K>*, OrderedSegmentCmp>&)PriorityQueue<Segment<K>*, OrderedSegmentCmp>(&m_orderSegmentCmp), (const HashSet<Segment<K>*>&)HashSet<Segment<K>*>(), (const UserSpaceLock&)UserSpaceLock()),
+	m_orderSegmentList((const PriorityQueue<Segment<K>*, OrderedSegmentCmp>&)PriorityQueue<Segment<K>*, OrderedSegmentCmp>(&m_orderSegmentCmp), (const HashSet<Segment<K>*>&)HashSet<Segment<K>*>(), (const FutexLock&)FutexLock()),
 	m_orderSegmentMode(MODE_INDEX),
 
 	m_branchSegmentTreeMap(m_comparator, Properties::DEFAULT_SEGMENT_BRANCH_ORDER),
+	m_histogram(m_comparator, m_keyBuilder),
 
 	m_summaries(null),
 	m_checkptTriggered(false),
 	m_fileCleanupTime(0),
 
+	m_hotSetList(null),
+	m_hotSetCursor(0),
+	m_hotSetTime(0),
+
 	m_localityCmp(null),
 
+	m_latency((Properties::getLatencyStatistics() == true) ? new RealTimeLatency() : null),
+
 	m_pendingCommits(0),
 
 	m_compressionRatioKey(CHAR_MIN),
@@ -210,6 +222,10 @@ RealTimeMap<K>::~RealTimeMap(void) {
 		Converter<PagedSummarySet*>::destroy(m_summaries);
 	}
 
+	if (m_hotSetList != null) {
+		delete m_hotSetList;
+	}
+
 	if (m_localityCmp != null) {
 		Converter<Comparator<Locality&>*>::destroy(m_localityCmp);
 	}
@@ -246,6 +262,11 @@ RealTimeMap<K>::~RealTimeMap(void) {
 	if (m_primaryIndex != null) {
 		m_share.setAwaitingDeletion(null, null);
 	}
+
+	if (m_latency != null) {
+		delete m_latency;
+		m_latency = null;
+	}
 }
 
 template<typename K>
@@ -292,7 +313,15 @@ inttype RealTimeMap<K>::purgeCache(boolean index, boolean deep, boolean log) {
 		inttype compressedDataPurge = 0;
 		PurgeReport purgeReport;
 
-		purged = purgeCacheManagement(active, index /* on index thread */, &compressed, &compressedDataPurge, purgeReport);
+		{
+			RealTimeTrace::Span span((index == true) ? "purge (index)" : "purge", getIdentifier());
+
+			purged = purgeCacheManagement(active, index /* on index thread */, &compressed, &compressedDataPurge, purgeReport);
+
+			span.setCounts("purged", purged, "requested", active);
+
+			RealTimeMetrics::SEGMENTS_PURGED.add(purged);
+		}
 
 		if ((purged != 0) || ((log == true) && (index == false))) {
 			if (index == true) {
@@ -350,6 +379,10 @@ void RealTimeMap<K>::indexCache(boolean cycle, boolean* cont, boolean* reorg) {
 
 	indexCacheManagement(cont, reorg);
 
+	if (m_prefetchMode == true) {
+		warmCacheManagement(cont);
+	}
+
 	// XXX: cycle size used for purge optimization
 	if (cycle == true) {
 		m_cycleSize = size();
@@ -542,6 +575,10 @@ void RealTimeMap<K>::recoverComplete(longtype entries, const Locality& locality,
 
 	m_state = MAP_RUNNING;
 
+	if (m_hotSetList != null) {
+		RealTimeResource::continueTasks();
+	}
+
 	if (rebuild == false) {
 		DEEP_LOG(DEBUG, DCVRY, "store: %s, elapsed: %lld, segments: %d, size: %lld, mount finished... %p\n", getFilePath(), elapsed, getTotalSegments(), size(), this);
 
@@ -1239,10 +1276,17 @@ boolean RealTimeMap<K>::lockInformation(Transaction* tx, const bytearray pkey, X
 	// XXX: if populating the segment is required, override when dynamically indexing (i.e. everything is unique and locked)
 	boolean populate = (oldinfo != null) || (newinfo->getCreating() == false) || (getShare()->getHasPrimary() == false);
 	boolean checkExisting = false;
+	boolean deferred = false;
 	if (populate == true) {
 		if (m_state == MAP_INDXING) {
 			populate = false;
 			checkExisting = true;
+
+		// XXX: an unchanged non-unique key has nothing to check, buffer it in the segment until filled (resident entries win the fill)
+		} else if ((identical == true) && (getShare()->getHasPrimary() == true) && (Properties::getSecondaryDeferral() == true)) {
+			populate = false;
+			checkExisting = true;
+			deferred = true;
 		}
 	}
 
@@ -1314,11 +1358,18 @@ boolean RealTimeMap<K>::lockInformation(Transaction* tx, const bytearray pkey, X
 		}
 		#endif
 
-		SegMapEntry* infoEntry = addInformation(ctxt, CONTEXT_STACK_OBJECT(global), newkey, info, true /* enableCardinality */);
+		// XXX: a buffered key is already counted by the segment on disk
+		const boolean buffered = (deferred == true) && (segment->getVirtual() == true);
+
+		SegMapEntry* infoEntry = addInformation(ctxt, CONTEXT_STACK_OBJECT(global), newkey, info, (buffered == false) /* enableCardinality */);
 		infoEntry->getStoryLine().setStoryLock(newinfoRef.getStoryLine().getStoryLock());
 
 		// XXX: see paged segment dirty setting below
 		segment = CONTEXT_STACK_OBJECT(global).getSegment();
+
+		if (buffered == true) {
+			RealTimeMetrics::SECONDARY_DEFERRED.add();
+		}
 	}
 
 	// XXX: ensure changes are active until paged out
@@ -1498,6 +1549,71 @@ void RealTimeMap<K>::seekStatistics(ulongtype* oT, ulongtype* oI, boolean reset)
 	m_share.getVrtReadFileList()->unlock();
 }
 
+template<typename K>
+void RealTimeMap<K>::filterStatistics(ulongtype* fN, ulongtype* fP, boolean reset) {
+
+	longtype negative = m_filterNegative.get();
+	longtype positive = m_filterPositive.get();
+
+	if ((negative == 0) && (positive == 0)) {
+		return;
+	}
+
+	DEEP_LOG(DEBUG, STATS, "filters: negative: %12lld, false positive: %12lld - %s\n", negative, positive, getFilePath());
+
+	(*fN) += negative;
+	(*fP) += positive;
+
+	if (reset == true) {
+		m_filterNegative.addAndGet(-negative);
+		m_filterPositive.addAndGet(-positive);
+	}
+}
+
+template<typename K>
+void RealTimeMap<K>::metricStatistics(RealTimeMetrics* metrics) {
+	const char* map = getFilePath();
+
+	metrics->gauge("deep_map_entries", "Entries in the map", getEntrySize(), map);
+
+	metrics->gauge("deep_map_segments", "Segments in the map", getTotalSegments(), map);
+	metrics->gauge("deep_map_segments_purged", "Segments purged from cache in the map", getPurgedSegments(), map);
+
+	metrics->gauge("deep_map_key_files", "Key files of the map", m_share.getIrtWriteFileList()->size(), map);
+	if (m_primaryIndex == null) {
+		metrics->gauge("deep_map_info_files", "Info files of the map", m_share.getLrtWriteFileList()->size(), map);
+		metrics->gauge("deep_map_value_files", "Value files of the map", m_share.getVrtWriteFileList()->size(), map);
+	}
+
+	if (m_compressionRatioKey != CHAR_MIN) {
+		metrics->gauge("deep_map_compression_ratio_key", "Compression ratio of key blocks", m_compressionRatioKey, map);
+	}
+
+	if (m_compressionRatioKeyValue != CHAR_MIN) {
+		metrics->gauge("deep_map_compression_ratio_key_value", "Compression ratio of key/value blocks", m_compressionRatioKeyValue, map);
+	}
+
+	// XXX: read only (i.e. unlike seekStatistics, intervals are neither folded nor reset)
+	ulongtype seeks = 0;
+	m_share.getIrtReadFileList()->lock();
+	{
+		Iterator<BufferedRandomAccessFile*>* iter = m_share.getIrtReadFileList()->iterator();
+		while (iter->hasNext() == true) {
+			RandomAccessFile* file = iter->next();
+			if (file != null) {
+				seeks += file->m_seekTotal + file->m_seekInterval;
+			}
+		}
+		Converter<Iterator<BufferedRandomAccessFile*>*>::destroy(iter);
+	}
+	m_share.getIrtReadFileList()->unlock();
+
+	metrics->gauge("deep_map_key_seeks", "Key file seeks since the last seek statistics reset", seeks, map);
+
+	metrics->gauge("deep_map_filter_negatives", "Segment filter negatives since the last reset", m_filterNegative.get(), map);
+	metrics->gauge("deep_map_filter_false_positives", "Segment filter false positives since the last reset", m_filterPositive.get(), map);
+}
+
 template<typename K>
 longtype RealTimeMap<K>::findSummaryPaging(MeasuredRandomAccessFile* iwfile, const RealTimeLocality& lastLrtLocality, const uinttype recoveryEpoch) {
 	return RealTimeVersion<K>::findSummaryPaging(iwfile, this, lastLrtLocality, recoveryEpoch);
@@ -1591,6 +1707,8 @@ void RealTimeMap<K>::initialize(void) {
 	m_statisticsFlushTime = 0;
 	m_coldPointReadLimitReached = 0;
 
+	m_histogram.clear();
+
 	m_organizationTime = System::currentTimeMillis();
 	m_finalizationTime = m_organizationTime;
 }
@@ -1666,7 +1784,8 @@ void RealTimeMap<K>::seedFinalFile(void) {
 	}
 	Converter<Iterator<MeasuredRandomAccessFile*>*>::destroy(iwiter);
 
-	if (m_prefetchMode == true) {
+	// XXX: warm the recorded hot set on the work threads (see warmCacheManagement), otherwise read whole files ahead
+	if ((m_prefetchMode == true) && (seedHotSet() == false)) {
 		Iterator<BufferedRandomAccessFile*>* vriter = m_share.getVrtReadFileList()->iterator();
 		while (vriter->hasNext() == true) {
 			BufferedRandomAccessFile* vrfile = vriter->next();
@@ -1687,6 +1806,25 @@ void RealTimeMap<K>::seedFinalFile(void) {
 			}
 		}
 		Converter<Iterator<BufferedRandomAccessFile*>*>::destroy(vriter);
+
+		if (m_memoryMapMode == true) {
+			Iterator<BufferedRandomAccessFile*>* iriter = m_share.getIrtReadFileList()->iterator();
+			while (iriter->hasNext() == true) {
+				BufferedRandomAccessFile* irfile = iriter->next();
+				if (irfile == null) {
+					continue;
+				}
+
+				// XXX: asynchronous read-ahead of mapped paging (i.e. no copies through the file buffer)
+				m_share.acquire(irfile);
+				{
+					irfile->setAccessMode(BufferedRandomAccessFile::ACCESS_WILLNEED);
+					irfile->setAccessMode(BufferedRandomAccessFile::ACCESS_RANDOM);
+				}
+				m_share.release(irfile);
+			}
+			Converter<Iterator<BufferedRandomAccessFile*>*>::destroy(iriter);
+		}
 	}
 
 	if (m_share.getIrtWriteFileList()->size() == 0) {
@@ -2103,6 +2241,7 @@ void RealTimeMap<K>::addStreamFile(boolean release) {
 
 	MeasuredRandomAccessFile* lwfile = new MeasuredRandomAccessFile(lrname, "rw", MapFileUtil::LRT, Properties::DEFAULT_FILE_BUFFER);
 	lwfile->setOptimizeCount(m_optimizeStream /* disguise between pre/post optimizing files */);
+	lwfile->setDirectWrite(m_directWriteMode);
 	lwfile->setProtocol(Versions::GET_PROTOCOL_CURRENT());
 	lwfile->setFileIndex(fileIndex);
 	lwfile->setFileCreationTime(creationTime);
@@ -2113,6 +2252,7 @@ void RealTimeMap<K>::addStreamFile(boolean release) {
 
 	MeasuredRandomAccessFile* vwfile = new MeasuredRandomAccessFile(vrname, "rw", MapFileUtil::VRT, Properties::DEFAULT_FILE_BUFFER);
 	vwfile->setOptimizeCount(m_optimizeStream /* disguise between pre/post optimizing files */);
+	vwfile->setDirectWrite(m_directWriteMode);
 	vwfile->setProtocol(Versions::GET_PROTOCOL_CURRENT());
 	vwfile->setFileIndex(fileIndex);
 	vwfile->setFileCreationTime(creationTime);
@@ -2163,7 +2303,7 @@ void RealTimeMap<K>::addStreamFile(boolean release) {
 	MapFileUtil::version(lwfile, m_share.getKeySize() /* TODO: should be schema hash */, Properties::DEFAULT_FILE_HEADER);
 	MapFileUtil::version(vwfile, m_share.getValueSize() /* TODO: should be schema hash */, Properties::DEFAULT_FILE_HEADER);
 
-	ExtraStatistics_v1::version(xwfile);
+	ExtraStatistics_v2::version(xwfile);
 	#if 0
 	// XXX: Always print the activation key when we first make a table
 	ExtraStatistics_v1::updateLicense(xwfile, Properties::getActivationKey(), Properties::getSystemUid(), true);
@@ -2276,6 +2416,7 @@ void RealTimeMap<K>::addPagingFile(boolean release) {
 	}
 
 	BufferedRandomAccessFile* irfile = new BufferedRandomAccessFile(irtname, "r", m_irtBuffer);
+	irfile->setMemoryMapped(m_memoryMapMode);
 	irfile->setProtocol(Versions::GET_PROTOCOL_CURRENT());
 	irfile->setWriter(iwfile);
 	irfile->setFileIndex(fileIndex);
@@ -2490,7 +2631,11 @@ void RealTimeMap<K>::flushSegmentMemory(void) {
 		deleteSegments();
 
 		if (m_memoryMode == false) {
+			RealTimeTrace::Span span("finalize", getIdentifier());
+
 			indexed = onlineFinalizingSegments(ctxt);
+
+			span.setCounts("indexed", indexed, "segments", getTotalSegments());
 		}
 	}
 	longtype stop = System::currentTimeMillis();
@@ -3562,7 +3707,7 @@ inttype RealTimeMap<K>::orderSegments(ThreadContext<K>* ctxt, boolean reset, boo
 
 				} else if ((viewpoint != 0) && ((stop - start) > Properties::DEFAULT_CACHE_LIMIT) && (indexed > 0)) {
 					DEEP_LOG(DEBUG, INDEX, "store: %s, elapsed: %lld, %c[%d;%dmcheckpoint indexed:%c[%d;%dm %d of %d\n", getFilePath(), (stop-start), 27,1,32,27,0, 25, indexed, m_orderSegmentList.size() + indexed);
-					if (purge > 0) {
+					if (*purge > 0) {
 						DEEP_LOG(DEBUG, PURGE, "store: %s, %c[%d;%dmcheckpoint indexing achieved:%c[%d;%dm %d of %d\n", getFilePath(), 27,1,33,27,0, 25, purgeCount, requestCount);
 					}
 					indexed = 0;
@@ -3656,6 +3801,274 @@ boolean RealTimeMap<K>::needsIndexing(Segment<K>* segment, const uinttype viewpo
 	return true;
 }
 
+template<typename K>
+void RealTimeMap<K>::histogramManagement(boolean force) {
+
+	longtype now = System::currentTimeMillis();
+	if ((force == false) && (m_histogram.stale(m_entrySize.get(), now) == false)) {
+		return;
+	}
+
+	// XXX: safe context lock: multiple readers / no writer on the branch tree
+	m_threadContext.readLock();
+	{
+		m_histogram.build(&m_branchSegmentTreeMap, Properties::DEFAULT_HISTOGRAM_BUCKETS, now);
+	}
+	m_threadContext.readUnlock();
+
+	// XXX: bucket boundaries are rebuilt from the branch tree on mount, only cardinality is persisted
+	if ((m_keyBuilder->getKeyParts() == 1) || (m_histogram.persist(now) == false)) {
+		return;
+	}
+
+	RealTimeShare* share = (m_primaryIndex == null) ? &m_share : m_primaryIndex->getShare();
+
+	RandomAccessFile* xwfile = share->getXrtWriteFileList()->last();
+	if (xwfile != null) {
+		m_histogram.store(&m_extraStats);
+
+		share->acquire(xwfile);
+		{
+			ExtraStatistics_v2::updateCardinality(xwfile, &m_extraStats, m_keyBuilder->getKeyParts(), m_schemaBuilder->getKeyName());
+		}
+		share->release(xwfile);
+	}
+}
+
+template<typename K>
+void RealTimeMap<K>::recordHotSet(void) {
+
+	m_hotSetTime = System::currentTimeMillis();
+
+	// XXX: keep the previous hot set until warming of it has completed
+	if ((Properties::getHotSetLimit() == 0) || (m_hotSetList != null)) {
+		return;
+	}
+
+	// XXX: bucket segments by highest heat bit, emitted hottest first
+	BasicArray<K>* levels[8] = { null, null, null, null, null, null, null, null };
+	inttype total = 0;
+
+	// XXX: safe context lock: multiple readers / no writer on the branch tree
+	m_threadContext.readLock();
+	if (m_branchSegmentTreeMap.TreeMap<K,Segment<K>*>::size() != 0) {
+		typename TreeMap<K,Segment<K>*>::TreeMapEntrySet stackSegmentSet(true);
+
+		m_branchSegmentTreeMap.entrySet(&stackSegmentSet);
+		MapSegmentEntrySetIterator* segIter = (MapSegmentEntrySetIterator*) stackSegmentSet.reset();
+		while (segIter->MapSegmentEntrySetIterator::hasNext()) {
+			const MapEntry<K,Segment<K>*>* segEntry = segIter->MapSegmentEntrySetIterator::next();
+			Segment<K>* segment = segEntry->getValue();
+
+			// XXX: heat decays by half per record, segments not hit since become cold
+			ubytetype heat = segment->coolHeat();
+			if ((heat == 0) || (segment->getSummary() == true) || (segment->getPurged() == true)) {
+				continue;
+			}
+
+			inttype level = 7;
+			while ((heat >> level) == 0) {
+				level--;
+			}
+
+			if (levels[level] == null) {
+				levels[level] = new BasicArray<K>(Properties::DEFAULT_FILE_HOT_SET_BATCH, true /* delete */);
+			}
+
+			levels[level]->add(m_keyBuilder->cloneKey(segEntry->getKey()), true /* realloc */, 0 /* i.e. grow by half */);
+			total++;
+		}
+	}
+	m_threadContext.readUnlock();
+
+	if (total > Properties::getHotSetLimit()) {
+		total = Properties::getHotSetLimit();
+	}
+
+	// XXX: nothing has been hit since the last record, keep the previous hot set
+	if (total != 0) {
+		String hname = String(getFilePath()) + MapFileUtil::FILE_SUFFIX_HRT;
+		String tname = hname + ".tmp";
+
+		if (FileUtil::exists(tname) == true) {
+			FileUtil::clobber(tname);
+		}
+
+		BufferedRandomAccessFile hwfile(tname, "rw", Properties::DEFAULT_FILE_BUFFER);
+		hwfile.setOnline(true);
+		{
+			hwfile.writeShort(m_share.getKeyProtocol());
+			hwfile.writeInt(total);
+
+			inttype written = 0;
+			for (inttype level = 7; (level >= 0) && (written < total); level--) {
+				for (int i = 0; (levels[level] != null) && (i < levels[level]->size()) && (written < total); i++, written++) {
+					KeyProtocol_v1<K>::writeKey(levels[level]->get(i), &hwfile, m_share.getKeyProtocol());
+				}
+			}
+
+			hwfile.flush();
+		}
+		hwfile.setOnline(false);
+
+		if (FileUtil::move(tname, hname) == false) {
+			DEEP_LOG(WARN, FETCH, "store: %s, failed to record hot set: %s\n", getFilePath(), hname.data());
+
+		} else {
+			DEEP_LOG(DEBUG, FETCH, "store: %s, recorded hot set: %d of %d\n", getFilePath(), total, getActiveSegments());
+		}
+	}
+
+	for (int i = 0; i < 8; i++) {
+		if (levels[i] != null) {
+			delete levels[i];
+		}
+	}
+}
+
+template<typename K>
+boolean RealTimeMap<K>::seedHotSet(void) {
+
+	if (m_hotSetList != null) {
+		return true;
+	}
+
+	String hname = String(getFilePath()) + MapFileUtil::FILE_SUFFIX_HRT;
+	if ((Properties::getHotSetLimit() == 0) || (m_memoryMode == true) || (FileUtil::exists(hname) == false)) {
+		return false;
+	}
+
+	boolean eof = false;
+
+	BufferedRandomAccessFile hrfile(hname, "r", Properties::DEFAULT_FILE_BUFFER);
+	hrfile.setOnline(true);
+	hrfile.BufferedRandomAccessFile::seek(0);
+	{
+		shorttype protocol = hrfile.readShort(&eof);
+		inttype total = hrfile.readInt(&eof);
+
+		if ((eof == true) || (protocol != m_share.getKeyProtocol()) || (total <= 0)) {
+			DEEP_LOG(WARN, FETCH, "store: %s, ignoring invalid hot set: %s\n", getFilePath(), hname.data());
+
+			hrfile.setOnline(false);
+			return false;
+		}
+
+		if (total > Properties::getHotSetLimit()) {
+			total = Properties::getHotSetLimit();
+		}
+
+		m_hotSetList = new BasicArray<K>(total, true /* delete */);
+		m_hotSetCursor = 0;
+
+		for (int i = 0; i < total; i++) {
+			K key = KeyProtocol_v1<K>::readKey(&hrfile, protocol, &eof);
+			if (eof == true) {
+				Converter<K>::destroy(key);
+				break;
+			}
+
+			m_hotSetList->add(key);
+		}
+	}
+	hrfile.setOnline(false);
+
+	DEEP_LOG(DEBUG, FETCH, "store: %s, seeded hot set: %d\n", getFilePath(), m_hotSetList->size());
+
+	return true;
+}
+
+template<typename K>
+void RealTimeMap<K>::warmCacheManagement(boolean* cont) {
+
+	if (m_state != MAP_RUNNING) {
+		return;
+	}
+
+	if (m_hotSetList == null) {
+		if ((Properties::getHotSetInterval() != 0) && ((System::currentTimeMillis() - m_hotSetTime) > Properties::getHotSetInterval())) {
+			recordHotSet();
+		}
+
+		return;
+	}
+
+	ThreadContext<K>* ctxt = m_threadContext.getContext();
+
+	// XXX: fill a batch of hot segments per work cycle, the map is serving while warming
+	inttype warmed = 0;
+	while ((m_hotSetCursor < m_hotSetList->size()) && (warmed < Properties::DEFAULT_FILE_HOT_SET_BATCH)) {
+
+		// XXX: the hot set no longer fits (or never did), leave the rest to regular access
+		if (m_resource.getCacheUsage() != RealTimeResource::IGNORE) {
+			DEEP_LOG(DEBUG, FETCH, "store: %s, hot set warming stopped on cache usage: %d of %d\n", getFilePath(), m_hotSetCursor, m_hotSetList->size());
+
+			m_hotSetCursor = m_hotSetList->size();
+			break;
+		}
+
+		const K key = m_hotSetList->get(m_hotSetCursor++);
+
+		Segment<K>* segment = null;
+
+		RETRY:
+		// XXX: safe context lock: multiple readers / no writer on the branch tree
+		m_threadContext.readLock();
+		{
+			const MapEntry<K,Segment<K>*>* index = m_branchSegmentTreeMap.TreeMap<K,Segment<K>*>::floorEntry(key);
+			if (index != null) {
+				segment = index->getValue();
+
+				// XXX: resident segments are already warm
+				if ((segment->getSummary() == true) || (segment->getPurged() == true) || (segment->getVirtual() == true)) {
+					segment->incref();
+
+				} else {
+					segment = null;
+				}
+			}
+		}
+		m_threadContext.readUnlock();
+
+		if (segment == null) {
+			continue;
+		}
+
+		// XXX: contended segments are being filled (or used) by readers
+		if (segment->tryLock() == false) {
+			segment->decref();
+			continue;
+		}
+
+		if (segment->getBeenDeleted() == true) {
+			segment->unlock();
+			segment->decref();
+			continue;
+		}
+
+		segment->decref();
+
+		if (fillSetupSegment(ctxt, segment, true /* physical */, m_primaryIndex == null /* values */) == false) {
+			// XXX: summary was expanded, warm the segment the key now resolves to
+			segment = null;
+			goto RETRY;
+		}
+
+		segment->unlock();
+		warmed++;
+	}
+
+	if (m_hotSetCursor < m_hotSetList->size()) {
+		*cont = true;
+
+	} else {
+		DEEP_LOG(DEBUG, FETCH, "store: %s, hot set warmed: %d, segments: %d, active: %d\n", getFilePath(), m_hotSetList->size(), getTotalSegments(), getActiveSegments());
+
+		delete m_hotSetList;
+		m_hotSetList = null;
+	}
+}
+
 template<typename K>
 inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 
@@ -3684,6 +4097,7 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 	#endif
 
 	IndexReport indexReport;
+	RealTimeTrace::Span span("index", getIdentifier());
 
 	// XXX: periodically write out storage statistics (note: converting seconds to milli-seconds)
 	if ((m_primaryIndex == null) && ((System::currentTimeMillis() - m_statisticsFlushTime) > (Properties::getStatisticsFlushInterval() * 1000))) {
@@ -3708,7 +4122,7 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 					m_extraStats.setTotalSize(total);
 				}
 
-				ExtraStatistics_v1::updateSize(xwfile, &m_extraStats);
+				ExtraStatistics_v2::updateSize(xwfile, &m_extraStats);
 				#if 0
 				//XXX: Update License info only if it has changed
 				ExtraStatistics_v1::updateLicense(xwfile,Properties::getActivationKey(),Properties::getSystemUid(), Properties::getActivationKeyChange());
@@ -3725,6 +4139,8 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 		m_statisticsFlushTime = System::currentTimeMillis();
 	}
 
+	histogramManagement(false /* force */);
+
 	if ((m_primaryIndex == null) && (System::currentTimeMillis() - m_fileCleanupTime) > (Properties::getFileCleanupInterval() * 1000)) {
 		if (tryClobberLock() == true) {
 			const inttype max = m_share.getAwaitingDeletion()->size();
@@ -3828,9 +4244,15 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 	}
 
 	if (checkpoint == true) {
+		RealTimeTrace::Span checkpointSpan("checkpoint", getIdentifier());
+
 		const boolean summaryValid = getCheckpointValid();
 		if (Properties::getCheckpointMode() != Properties::CHECKPOINT_OFF) {
+			RealTimeTrace::Span summarySpan("summarize", getIdentifier());
+
 			summaryWorkspace.indexSummary(this, ctxt);
+
+			summarySpan.setCounts("summarized", summaryWorkspace.getSummarized(), "indexed", summaryWorkspace.getIndexed());
 		}
 		m_summaryLrtLocality = m_endwiseLrtLocality;
 
@@ -3879,6 +4301,8 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 			RealTimeAdaptive_v1<K>::clobberUnusedFiles(this);
 		}
 		clobberUnlock();
+
+		checkpointSpan.setCounts("summarized", summaryWorkspace.getSummarized(), "valid", summaryValid);
 	}
 
 	if (((m_state == MAP_RUNNING) || (m_state == MAP_RECOVER)) && (m_reindexing.get() == 0 /* no dynamic indexing */)) {
@@ -3936,6 +4360,10 @@ inttype RealTimeMap<K>::indexCacheManagement(boolean* cont, boolean* reorg) {
 		m_share.setValueAverage((inttype) (m_activeValueSize / m_activeValueCount));
 	}
 
+	span.setCounts("indexed", indexAchieved, "requested", indexRequest);
+
+	RealTimeMetrics::SEGMENTS_INDEXED.add(indexAchieved);
+
 	return indexAchieved;
 }
 
@@ -4026,6 +4454,15 @@ inttype RealTimeMap<K>::purgeCacheManagement(inttype active, boolean index, intt
 
 			if (segment->tryLock() == true) {
 
+				// XXX: second chance (i.e. gclock), recently hit segments are cooled and passed over while scan filled ones are taken
+				if ((segment->getPurged() == false) && (segment->getHeat() != 0) && (m_resource.getCacheUsage() < RealTimeResource::IMMENSE)) {
+					segment->coolHeat();
+					segment->unlock();
+
+					purgeReport.heat++;
+					continue;
+				}
+
 				// XXX: check whether cache pressure requires segment purging
 				if (purgeSegment(ctxt, segment, growing, index, false /* semi */, &purgeList, &compressList, purgeReport) == true) {
 					if (segment->getZipData() != null) {
@@ -4213,6 +4650,8 @@ inttype RealTimeMap<K>::onlineFinalizingSegments(ThreadContext<K>* ctxt) {
 template<typename K>
 boolean RealTimeMap<K>::reorganizeFiles(ThreadContext<K>* ctxt, boolean* cont, boolean valueReorganize, boolean valueCompression) {
 
+	RealTimeTrace::Span span((valueReorganize == true) ? "reorganize (values)" : "reorganize (keys)", getIdentifier());
+
 	inttype reorg = 0;
 	HashMap<ushorttype,uinttype> deadStats;
 	HashMap<ushorttype,uinttype> totalStats;
@@ -4502,6 +4941,8 @@ boolean RealTimeMap<K>::reorganizeFiles(ThreadContext<K>* ctxt, boolean* cont, b
 		}
 	}
 
+	span.setCounts("files", reorg, "compression", valueCompression);
+
 	return (reorg != 0);
 }
 
@@ -4590,7 +5031,7 @@ ushorttype RealTimeMap<K>::streamFileManagement(boolean lock, boolean create) {
 							m_extraStats.setTotalSize(total);
 						}
 
-						ExtraStatistics_v1::updateSize(xwfile, &m_extraStats, true /* force */);
+						ExtraStatistics_v2::updateSize(xwfile, &m_extraStats, true /* force */);
 
 						xwfile->setOnline(false);
 					}
@@ -4660,6 +5101,8 @@ boolean RealTimeMap<K>::markSegment(ThreadContext<K>* ctxt, Segment<K>* segment,
 template<typename K>
 void RealTimeMap<K>::fillSegment(ThreadContext<K>* ctxt, Segment<K>* segment, boolean values, boolean pace) {
 
+	RealTimeLatency::Timer timer(m_latency, RealTimeLatency::FILL);
+
 	boolean summary = segment->getSummary();
 
 	if (((m_memoryCompressMode == false) || (segment->getZipData() == null)) && (m_memoryMode == false)) {
@@ -4817,6 +5260,8 @@ boolean RealTimeMap<K>::purgeSegment(ThreadContext<K>* ctxt, Segment<K>* segment
 		return false;
 	}
 
+	RealTimeLatency::Timer timer(m_latency, RealTimeLatency::PURGE);
+
 	boolean compress = RealTimeAdaptive_v1<K>::allowMemoryCompression(this, segment, m_memoryCompressMode, m_memoryMode, growing);
 
 	if ((compress == false) || (compressList == null)) {
@@ -4888,6 +5333,22 @@ boolean RealTimeMap<K>::purgeSegment(ThreadContext<K>* ctxt, Segment<K>* segment
 	} else {
 
 		if (compress == false) {
+			SegmentFilter* filter = null;
+
+			// XXX: the resident keyset is complete here, remember it for negative lookups while purged
+			if ((isVirtual == false) && (m_primaryIndex == null) && (m_keyBuilder->isPrimitive() == true) && (Properties::getSegmentFilterBits() != 0)) {
+				filter = new SegmentFilter(segment->SegTreeMap::size(), Properties::getSegmentFilterBits());
+
+				typename SegTreeMap::TreeMapEntrySet stackSegmentItemSet(true);
+
+				segment->SegTreeMap::entrySet(&stackSegmentItemSet);
+				MapInformationEntrySetIterator* infoIter = (MapInformationEntrySetIterator*) stackSegmentItemSet.iterator();
+				while (infoIter->MapInformationEntrySetIterator::hasNext()) {
+					SegMapEntry* infoEntry = infoIter->MapInformationEntrySetIterator::next();
+					filter->add(Converter<K>::hashCode(infoEntry->getKey()));
+				}
+			}
+
 			K firstKey = segment->SegTreeMap::firstKey();
 			Information* firstValue = segment->SegTreeMap::remove(firstKey);
 
@@ -4928,6 +5389,7 @@ boolean RealTimeMap<K>::purgeSegment(ThreadContext<K>* ctxt, Segment<K>* segment
 
 			segment->SegTreeMap::put(firstKey, firstValue);
 
+			segment->setFilter(filter);
 
 		} else {
 			if (compressList != null) {
@@ -4958,6 +5420,8 @@ boolean RealTimeMap<K>::purgeSegment(ThreadContext<K>* ctxt, Segment<K>* segment
 template<typename K>
 boolean RealTimeMap<K>::indexSegment(ThreadContext<K>* ctxt, Segment<K>* segment, boolean rebuild, uinttype viewpoint, boolean backwardCheckpoint, RealTimeSummary<K>* summaryWorkspace, IndexReport* indexReport) {
 
+	RealTimeLatency::Timer timer(m_latency, RealTimeLatency::INDEX);
+
 	IndexReport _indexReport;
 	if (indexReport == null) {
 		indexReport = &_indexReport;
@@ -5801,6 +6265,9 @@ Segment<K>* RealTimeMap<K>::getSegment(ThreadContext<K>* ctxt, const K key, bool
 
 			if (trySetupSegment(ctxt, segment) == true) {
 				m_threadContext.readUnlock();
+
+				// XXX: only point access heats segments, scans and iterator fills stay cold (see purgeCacheManagement)
+				segment->incrementHeat();
 				return segment;
 			}
 		}
@@ -5876,9 +6343,49 @@ Segment<K>* RealTimeMap<K>::getSegment(ThreadContext<K>* ctxt, const K key, bool
 		}
 	}
 
+	if (segment != null) {
+		segment->incrementHeat();
+	}
+
 	return segment;
 }
 
+template<typename K>
+boolean RealTimeMap<K>::filterSegment(ThreadContext<K>* ctxt, const K key, boolean* consulted) {
+
+	boolean absent = false;
+
+	// XXX: safe context lock: multiple readers / no writer on the branch tree
+	if (m_threadContext.tryReadLock() == false) {
+		return false;
+	}
+	{
+		const MapEntry<K,Segment<K>*>* index = m_branchSegmentTreeMap.TreeMap<K,Segment<K>*>::floorEntry(key);
+		if (index != null) {
+			Segment<K>* segment = index->getValue();
+			if (segment->tryLock() == true) {
+
+				// XXX: a filter is only kept while the purged keyset is unchanged (see Segment::setPurged)
+				const SegmentFilter* filter = segment->getFilter();
+				if ((filter != null) && (segment->getPurged() == true) && (segment->getVirtual() == false) && (segment->getSummary() == false)) {
+
+					// XXX: first key is always resident
+					if (segment->SegTreeMap::containsKey(key) == false) {
+						*consulted = true;
+
+						absent = (filter->contains(Converter<K>::hashCode(key)) == false);
+					}
+				}
+
+				segment->unlock();
+			}
+		}
+	}
+	m_threadContext.readUnlock();
+
+	return absent;
+}
+
 template<typename K>
 Segment<K>* RealTimeMap<K>::scanSegment(ThreadContext<K>* ctxt, const K key, boolean values) {
 	const MapEntry<K,Segment<K>*>* entry = scanEntry(ctxt, key, values);
@@ -6162,9 +6669,22 @@ template<typename K>
 boolean RealTimeMap<K>::get(ThreadContext<K>* ctxt, const K key, nbyte* value, K* retkey, boolean* again, LockOption lock) {
 	boolean result = false;
 
+	// XXX: definite misses on purged primary segments avoid a fill (i.e. secondaries match on partial keys)
+	boolean filtered = false;
+	if ((m_primaryIndex == null) && (m_keyBuilder->isPrimitive() == true) && (m_state != MAP_RECOVER)) {
+		if (filterSegment(ctxt, key, &filtered) == true) {
+			m_filterNegative.incrementAndGet();
+			return false;
+		}
+	}
+
 	RETRY:
 	Segment<K>* segment = (value == null) ? getSegment(ctxt, key, false, true) : scanSegment(ctxt, key, true);
 	if (segment != null) {
+		if (value != null) {
+			segment->incrementHeat();
+		}
+
 		const SegMapEntry* infoEntry = segment->SegTreeMap::getEntry(key);
 		if (infoEntry != null) {
 			Information* info = infoEntry->getValue();
@@ -6229,6 +6749,10 @@ boolean RealTimeMap<K>::get(ThreadContext<K>* ctxt, const K key, nbyte* value, K
 		segment->unlock();
 	}
 
+	if ((filtered == true) && (result == false)) {
+		m_filterPositive.incrementAndGet();
+	}
+
 	return result;
 }
 
@@ -9273,6 +9797,8 @@ boolean RealTimeMap<K>::removeTransaction(const K key, nbyte* value, DeleteOptio
 template<typename K>
 boolean RealTimeMap<K>::get(const K key, nbyte* value, ReadOption option, K* retkey, Transaction* tx, LockOption lock, MapInformationEntryIterator* iterator, RealTimeCondition<K>* condition) {
 
+	RealTimeLatency::Timer timer(m_latency, (option == EXACT) ? RealTimeLatency::GET : RealTimeLatency::GET_NEXT);
+
 	ThreadContext<K>* ctxt;
 	if (tx != null) {
 		ctxt = getTransactionContext(tx);
@@ -9421,6 +9947,8 @@ boolean RealTimeMap<K>::contains(const K key, ReadOption option, K* retkey, Tran
 template<typename K>
 boolean RealTimeMap<K>::put(const K key, const nbyte* value, WriteOption option, Transaction* tx, LockOption lock, uinttype position, ushorttype index, uinttype compressedOffset) {
 
+	RealTimeLatency::Timer timer(m_latency, RealTimeLatency::PUT);
+
 	#ifdef DEEP_DEBUG
 	if ((m_state > MAP_RUNNING) && (m_state != MAP_RECOVER)) {
 		DEEP_LOG(ERROR, OTHER, "Invalid state: not running, %s\n", getFilePath());
@@ -9447,6 +9975,8 @@ boolean RealTimeMap<K>::put(const K key, const nbyte* value, WriteOption option,
 template<typename K>
 boolean RealTimeMap<K>::remove(const K key, nbyte* value, DeleteOption option, Transaction* tx, LockOption lock, boolean forCompressedUpdate) {
 
+	RealTimeLatency::Timer timer(m_latency, RealTimeLatency::REMOVE);
+
 	#ifdef DEEP_DEBUG
 	if ((m_state > MAP_RUNNING) && (m_state != MAP_RECOVER)) {
 		DEEP_LOG(ERROR, OTHER, "Invalid state: not running, %s\n", getFilePath());
@@ -9476,6 +10006,74 @@ boolean RealTimeMap<K>::remove(const K key, nbyte* value, DeleteOption option, T
 	return removeTransaction(key, value, option, tx, lock, forCompressedUpdate);
 }
 
+template<typename K>
+boolean RealTimeMap<K>::write(RealTimeWriteBatch<K>* batch, Transaction* tx) {
+
+	if (batch->m_map != this) {
+		DEEP_LOG(ERROR, OTHER, "Write: batch of another map, %s\n", getFilePath());
+
+		throw InvalidException("Write: batch of another map");
+	}
+
+	#ifdef DEEP_DEBUG
+	if ((m_state > MAP_RUNNING) && (m_state != MAP_RECOVER)) {
+		DEEP_LOG(ERROR, OTHER, "Invalid state: not running, %s\n", getFilePath());
+
+		throw InvalidException("Invalid state: not running");
+	}
+
+	if (m_primaryIndex != null) {
+		DEEP_LOG(ERROR, OTHER, "Write: secondary not supported, %s\n", getFilePath());
+
+		throw PermissionException("Write: secondary not supported");
+	}
+
+	if (tx == null) {
+		DEEP_LOG(ERROR, OTHER, "Write: transaction required, %s\n", getFilePath());
+
+		throw PermissionException("Write: transaction required");
+	}
+	#endif
+
+	batch->m_failed = -1;
+
+	if (batch->size() == 0) {
+		return true;
+	}
+
+	// XXX: key order keeps consecutive operations on the same segment, which stays filled and cache hot between them
+	batch->sort(m_comparator);
+
+	// XXX: a nested level makes the batch all or nothing, the caller's commit writes it out in one pass (single conductor)
+	const shorttype level = tx->begin();
+	associate(tx);
+
+	nbyte value((inttype) 0);
+
+	for (inttype i = 0; i < batch->m_operations.size(); i++) {
+		typename RealTimeWriteBatch<K>::Operation* operation = batch->m_operations.get(i);
+
+		boolean result;
+		if (operation->m_value != null) {
+			result = putTransaction(operation->m_key, operation->m_value, operation->m_option, tx, LOCK_WRITE, 0, 0, Information::OFFSET_NONE);
+
+		} else {
+			result = removeTransaction(operation->m_key, &value, DELETE_RETURN, tx, LOCK_WRITE, false);
+		}
+
+		if (result == false) {
+			batch->m_failed = operation->m_sequence;
+
+			tx->rollback(level);
+			return false;
+		}
+	}
+
+	tx->commit(level);
+
+	return true;
+}
+
 template<typename K>
 boolean RealTimeMap<K>::reserve(ulongtype offset, ulongtype block, ulongtype& first, ulongtype& reserved, Transaction* tx) {
 
@@ -9709,10 +10307,17 @@ void RealTimeMap<K>::rollbackSchema(void) {
 template<typename K>
 longtype RealTimeMap<K>::range(const K* skey, const K* ekey, Transaction* tx) {
 
+	longtype total = 0;
+
+	// XXX: answer from the histogram unless both keys fall into one resident bucket (see RealTimeHistogram)
+	if (m_histogram.range(skey, ekey, m_entrySize.get(), &total) == true) {
+		return total;
+	}
+
 	ThreadContext<K>* ctxt = (tx != null) ? getTransactionContext(tx) : m_threadContext.getContext();
 
 	RETRY:
-	longtype total = 0;
+	total = 0;
 	MapSegmentIterator iterator;
 
 	// XXX: safe context lock: multiple readers / no writer on the branch tree
@@ -9919,6 +10524,10 @@ longtype RealTimeMap<K>::length(FileOption fileType, Transaction* tx) {
 template<typename K>
 void RealTimeMap<K>::cardinality(longtype* stats, Transaction* tx, boolean recalculate) {
 
+	if ((recalculate == false) && (m_histogram.cardinality(stats, m_entrySize.get()) == true)) {
+		return;
+	}
+
 	ThreadContext<K>* ctxt = null;
 	if (recalculate == true) {
 		ctxt = m_threadContext.getContext();
@@ -10089,6 +10698,10 @@ void RealTimeMap<K>::cardinality(longtype* stats, Transaction* tx, boolean recal
 		}
 	}
 	m_threadContext.readUnlock();
+
+	if (recalculate == true) {
+		histogramManagement(true /* force */);
+	}
 }
 
 template<typename K>
@@ -10168,6 +10781,11 @@ boolean RealTimeMap<K>::mount(boolean reserve, Transaction* tx) {
 
 		if (success == true) {
 			DEEP_LOG(DEBUG, DCVRY, "store: %s, elapsed: %lld, segments: %d, size: %lld, mount finished... %p\n", getFilePath(), elapsed, getTotalSegments(), size(), this);
+
+			m_histogram.seed(&m_extraStats, stop);
+			histogramManagement(true /* force */);
+
+			m_hotSetTime = stop;
 		}
 
 		if ((success == false) && (m_threadContext.getErrorCode() == ERR_SUCCESS)) {
@@ -10187,6 +10805,11 @@ boolean RealTimeMap<K>::mount(boolean reserve, Transaction* tx) {
 	return success;
 }
 
+template<typename K>
+boolean RealTimeMap<K>::mount(RealTimeMap<K>** maps, inttype size, inttype threads) {
+	return RealTimeMount<K>::concurrently(maps, size, threads);
+}
+
 template<typename K>
 boolean RealTimeMap<K>::unmount(boolean destroy, Transaction* tx) {
 
@@ -10246,6 +10869,10 @@ boolean RealTimeMap<K>::unmount(boolean destroy, Transaction* tx) {
 
 		longtype start = System::currentTimeMillis();
 		{
+			if ((m_prefetchMode == true) && (m_memoryMode == false)) {
+				recordHotSet();
+			}
+
 			flushSegmentMemory();
 
 			if (m_memoryMode == false) {
@@ -10292,7 +10919,7 @@ boolean RealTimeMap<K>::unmount(boolean destroy, Transaction* tx) {
 								m_extraStats.setTotalSize(total);
 							}
 
-							ExtraStatistics_v1::updateSize(xwfile, &m_extraStats);
+							ExtraStatistics_v2::updateSize(xwfile, &m_extraStats);
 
 							xwfile->setOnline(false);
 						}
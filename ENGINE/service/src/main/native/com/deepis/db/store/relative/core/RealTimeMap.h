@@ -36,6 +36,7 @@
 #include "com/deepis/db/store/relative/util/Versions.h"
 
 #ifdef DEEP_USERLOCK
+	#include "cxx/util/concurrent/locks/FutexLock.h"
 	#include "cxx/util/concurrent/locks/UserSpaceLock.h"
 #else
 	#include "cxx/util/concurrent/locks/ReentrantLock.h"
@@ -61,6 +62,7 @@
 #include "com/deepis/db/store/relative/core/RealTimeSchema.h"
 #include "com/deepis/db/store/relative/core/RealTimeCompress.h"
 #include "com/deepis/db/store/relative/core/RealTimeSummary.h"
+#include "com/deepis/db/store/relative/core/RealTimeHistogram.h"
 #include "com/deepis/db/store/relative/core/RealTimeTransaction.h"
 #include "com/deepis/db/store/relative/core/RealTimeUtilities.h"
 
@@ -76,6 +78,8 @@ namespace com { namespace deepis { namespace db { namespace store { namespace re
 template <typename K> class RealTimeIterator;
 template <typename K> class RealTimeDiscover;
 template <typename K> class RealTimeRecovery;
+template <typename K> class RealTimeMount;
+template <typename K> class RealTimeWriteBatch;
 template <typename K> class RealTimeConductor;
 template <typename K> class RealTimeUtilities;
 
@@ -153,7 +157,7 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		};
 
 	private:
-		typedef QueueSet<Segment<K>*, PriorityQueue<Segment<K>*, OrderedSegmentCmp>, HashSet<Segment<K>*>, UserSpaceLock> OrderedSegmentList;
+		typedef QueueSet<Segment<K>*, PriorityQueue<Segment<K>*, OrderedSegmentCmp>, HashSet<Segment<K>*>, FutexLock> OrderedSegmentList;
 
 		MapState m_state;
 		RealTimeResource m_resource;
@@ -166,6 +170,8 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		const boolean m_singularMode;
 		const boolean m_prefetchMode;
 		const boolean m_rowStoreMode;
+		const boolean m_memoryMapMode;
+		const boolean m_directWriteMode;
 		/* const */ boolean m_keyCompressMode;
 		/* const */ boolean m_valueCompressMode;
 		/* const */ boolean m_memoryCompressMode;
@@ -204,6 +210,8 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 
 		AtomicLong m_purgeSize;
 		AtomicLong m_coldPointRead;
+		AtomicLong m_filterNegative;
+		AtomicLong m_filterPositive;
 		boolean m_coldPointReadLimitReached;
 
 		boolean m_resetIterator;
@@ -211,6 +219,9 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		boolean m_hasReservation;
 		boolean m_hasSecondaryMaps;
 
+		// XXX: directory listing shared across a concurrent mount (see RealTimeMount)
+		const ArrayList<String*>* m_discoverScan;
+
 		boolean m_irtBuildReorganization;
 		boolean m_irtForceReorganization;
 		boolean m_vrtForceReorganization;
@@ -229,13 +240,22 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		OrderedSegmentMode m_orderSegmentMode;
 
 		TreeMap<K,Segment<K>*> m_branchSegmentTreeMap;
+		RealTimeHistogram<K> m_histogram;
 
 		PagedSummarySet* m_summaries;
 		boolean m_checkptTriggered;
 		longtype m_fileCleanupTime;
 
+		// XXX: hottest first segment keys recorded at the last unmount (see O_PREFETCH)
+		BasicArray<K>* m_hotSetList;
+		inttype m_hotSetCursor;
+		longtype m_hotSetTime;
+
 		Comparator<Locality&>* m_localityCmp;
 
+		// XXX: null unless latency statistics were enabled when the map was created (see Properties)
+		RealTimeLatency* m_latency;
+
 		ulongtype m_pendingCommits;
 
 		bytetype m_compressionRatioKey;
@@ -316,6 +336,8 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 			#endif
 
 			virtual void seekStatistics(ulongtype* oT, ulongtype* oI, boolean reset);
+			virtual void filterStatistics(ulongtype* fN, ulongtype* fP, boolean reset);
+			virtual void metricStatistics(RealTimeMetrics* metrics);
 
 			virtual longtype findSummaryPaging(MeasuredRandomAccessFile* iwfile, const RealTimeLocality& lastLrtLocality, const uinttype recoveryEpoch);
 			virtual boolean initSummaryPaging(MeasuredRandomAccessFile* iwfile);
@@ -393,6 +415,10 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		inline inttype compressSegments(BasicArray<Segment<K>*>* segments, ThreadContext<K>* ctxt, boolean index, boolean growing);
 		inline inttype orderSegments(ThreadContext<K>* ctxt, boolean reset, boolean timeout, boolean* cont, boolean* reorg, inttype* request = null, inttype* purge = null, uinttype viewpoint = 0, RealTimeSummary<K>* summaryWorkspace = null, IndexReport* indexReport = null);
 
+		inline void histogramManagement(boolean force);
+		inline void recordHotSet(void);
+		inline boolean seedHotSet(void);
+		inline void warmCacheManagement(boolean* cont);
 		inline inttype indexCacheManagement(boolean* cont, boolean* reorg);
 		inline inttype purgeCacheManagement(inttype active, boolean index, inttype* compressed, inttype* compressedDataPurge, PurgeReport& purgeReport);
 		FORCE_INLINE boolean needsIndexing(Segment<K>* segment, const uinttype viewpoint, const boolean final, boolean reorg, boolean* summarize, boolean* backwardCheckpoint);
@@ -438,6 +464,7 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		FORCE_INLINE Segment<K>* firstSegment(ThreadContext<K>* ctxt, const K key, boolean create);
 		FORCE_INLINE Segment<K>* getSegment(ThreadContext<K>* ctxt, const K key, boolean create, boolean fill = true, boolean forceSegmentLock = true, boolean forceContextLock = true, boolean* wasClosed = null, boolean openSegment = false);
 		FORCE_INLINE Segment<K>* scanSegment(ThreadContext<K>* ctxt, const K key, boolean values);
+		FORCE_INLINE boolean filterSegment(ThreadContext<K>* ctxt, const K key, boolean* consulted);
 		FORCE_INLINE Segment<K>* getNextSegment(ThreadContext<K>* ctxt, const K key, boolean values);
 		FORCE_INLINE Segment<K>* getPreviousSegment(ThreadContext<K>* ctxt, const K key, boolean values);
 		FORCE_INLINE Segment<K>* lastSegment(ThreadContext<K>* ctxt, const K key, boolean create);
@@ -526,10 +553,22 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 			if (mode == 1 /* durable-phase2 */) {
 				commitCacheMemory(conductor);
 				__sync_sub_and_fetch(&m_pendingCommits, 1);
+
+				// XXX: durable commits are timed across both phases (i.e. including the sync, see RealTimeLatency::SYNC)
+				if (m_latency != null) {
+					m_latency->record(RealTimeLatency::COMMIT, RealTimeLatency::ticks() - conductor->getCommitTicks());
+				}
+
 				return;
 			}
 
+			if ((mode == 2 /* durable-phase1 */) && (m_latency != null)) {
+				conductor->setCommitTicks(RealTimeLatency::ticks());
+			}
+
 			/* if ((mode == 0 non-durable) || (mode == 2)) */ {
+				RealTimeLatency::Timer timer((mode == 0) ? m_latency : null, RealTimeLatency::COMMIT);
+
 				m_checkptRequestLock.readLock();
 				__sync_add_and_fetch(&m_pendingCommits, 1);
 
@@ -546,6 +585,8 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 			}
 		#else
 		FORCE_INLINE void commit(RealTimeConductor<K>* conductor) {
+			RealTimeLatency::Timer timer(m_latency, RealTimeLatency::COMMIT);
+
 			m_checkptRequestLock.readLock();
 			__sync_add_and_fetch(&m_pendingCommits, 1);
 
@@ -579,6 +620,7 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 
 		boolean put(const K key, const nbyte* value, WriteOption option = STANDARD, Transaction* tx = null, LockOption lock = LOCK_WRITE, uinttype position = 0, ushorttype index = 0, uinttype compressedOffset = Information::OFFSET_NONE);
 		boolean remove(const K key, nbyte* value, DeleteOption option = DELETE_RETURN, Transaction* tx = null, LockOption lock = LOCK_WRITE, boolean forCompressedUpdate = false);
+		boolean write(RealTimeWriteBatch<K>* batch, Transaction* tx);
 
 		boolean reserve(ulongtype offset, ulongtype block, ulongtype& first, ulongtype& reserved, Transaction* tx);
 
@@ -649,6 +691,9 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 			boolean mount(boolean reserve = false, Transaction* tx = null);
 			boolean unmount(boolean destroy = true, Transaction* tx = null);
 
+			// XXX: mount a batch of maps (i.e. many tables) concurrently, secondaries are ordered after their primary
+			static boolean mount(RealTimeMap<K>** maps, inttype size, inttype threads = 0 /* work threads */);
+
 			boolean clobber(boolean final = false);
 			boolean clear(boolean final = false);
 		//
@@ -689,6 +734,10 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 			return &m_extraStats;
 		}
 
+		virtual RealTimeLatency* getLatency(void) {
+			return m_latency;
+		}
+
 		virtual const char* getFilePath(void) const {
 			return m_filePath.getPath();
 		}
@@ -796,6 +845,8 @@ class RealTimeMap /* XXX: pseudo-map/tree interface */ : public RealTimeIndex {
 		friend class RealTimeIterator<K>;
 		friend class RealTimeDiscover<K>;
 		friend class RealTimeRecovery<K>;
+		friend class RealTimeMount<K>;
+		friend class RealTimeWriteBatch<K>;
 		friend class RealTimeConductor<K>;
 		friend class RealTimeUtilities<K>;
 
@@ -0,0 +1,266 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMETRICS_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMETRICS_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "cxx/lang/types.h"
+#include "cxx/util/Logger.h"
+
+using namespace cxx::lang;
+using namespace cxx::util;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: metrics in prometheus text exposition format, counters are fed by the engine and gauges are sampled by the stats thread on export
+class RealTimeMetrics {
+
+	public:
+		enum Type {
+			COUNTER,
+			GAUGE
+		};
+
+		// XXX: lock-free event counter (i.e. threads add into a shard chosen by thread hash, export sums the shards)
+		class Counter {
+
+			private:
+				static const uinttype SHARDS = 8;
+
+				struct Shard {
+					volatile ulongtype m_value;
+					char m_pad[64 - sizeof(ulongtype)];
+				};
+
+				Shard m_shards[SHARDS];
+
+				const char* m_name;
+				const char* m_help;
+				Counter* m_next;
+
+			public:
+				Counter(const char* name, const char* help):
+					m_name(name),
+					m_help(help),
+					m_next(null) {
+
+					memset(m_shards, 0, sizeof(m_shards));
+
+					do {
+						m_next = s_counters;
+					} while (__sync_bool_compare_and_swap(&s_counters, m_next, this) == false);
+				}
+
+				FORCE_INLINE void add(ulongtype value = 1) {
+					const ulongtype hash = ((ulongtype) pthread_self()) * 0x9e3779b97f4a7c15ULL;
+
+					__sync_add_and_fetch(&m_shards[(hash >> 32) % SHARDS].m_value, value);
+				}
+
+				ulongtype get(void) const {
+					ulongtype value = 0;
+					for (uinttype i = 0; i < SHARDS; i++) {
+						value += m_shards[i].m_value;
+					}
+
+					return value;
+				}
+
+				FORCE_INLINE const char* getName(void) const {
+					return m_name;
+				}
+
+				FORCE_INLINE const char* getHelp(void) const {
+					return m_help;
+				}
+
+				FORCE_INLINE const Counter* getNext(void) const {
+					return m_next;
+				}
+		};
+
+		// XXX: engine counters (see RealTimeMap and MeasuredRandomAccessFile)
+		static Counter SEGMENTS_PURGED;
+		static Counter SEGMENTS_INDEXED;
+		static Counter FILE_SYNCS;
+		static Counter FILE_BYTES_WRITTEN;
+		static Counter SECONDARY_DEFERRED;
+
+	private:
+		static const inttype FAMILIES = 64;
+
+		// XXX: samples are grouped per metric name as the format requires, whatever order they are added in
+		struct Family {
+			const char* m_name;
+			const char* m_help;
+			Type m_type;
+
+			FILE* m_stream;
+			char* m_buffer;
+			size_t m_size;
+		};
+
+		static Counter* volatile s_counters;
+
+		Family m_families[FAMILIES];
+		inttype m_size;
+
+		Family* family(const char* name, const char* help, Type type) {
+			for (inttype i = 0; i < m_size; i++) {
+				if (strcmp(m_families[i].m_name, name) == 0) {
+					return &m_families[i];
+				}
+			}
+
+			if (m_size == FAMILIES) {
+				return null;
+			}
+
+			Family* family = &m_families[m_size];
+			family->m_name = name;
+			family->m_help = help;
+			family->m_type = type;
+			family->m_buffer = null;
+			family->m_size = 0;
+			family->m_stream = open_memstream(&family->m_buffer, &family->m_size);
+			if (family->m_stream == null) {
+				return null;
+			}
+
+			m_size++;
+
+			return family;
+		}
+
+		// XXX: label values are paths, escape as the format requires
+		static void label(FILE* stream, const char* value) {
+			for (const char* c = value; *c != '\0'; c++) {
+				switch (*c) {
+					case '\\': fputs("\\\\", stream); break;
+					case '"':  fputs("\\\"", stream); break;
+					case '\n': fputs("\\n", stream); break;
+					default:   fputc(*c, stream); break;
+				}
+			}
+		}
+
+		static const char* typeToString(Type type) {
+			return (type == COUNTER) ? "counter" : "gauge";
+		}
+
+	public:
+		RealTimeMetrics(void):
+			m_size(0) {
+		}
+
+		~RealTimeMetrics(void) {
+			for (inttype i = 0; i < m_size; i++) {
+				fclose(m_families[i].m_stream);
+				free(m_families[i].m_buffer);
+			}
+		}
+
+		// XXX: map is the optional value of the "map" label
+		void sample(const char* name, const char* help, Type type, doubletype value, const char* map = null) {
+			Family* f = family(name, help, type);
+			if (f == null) {
+				return;
+			}
+
+			fputs(name, f->m_stream);
+			if (map != null) {
+				fputs("{map=\"", f->m_stream);
+				label(f->m_stream, map);
+				fputs("\"}", f->m_stream);
+			}
+
+			fprintf(f->m_stream, " %.17g\n", value);
+		}
+
+		FORCE_INLINE void gauge(const char* name, const char* help, doubletype value, const char* map = null) {
+			sample(name, help, GAUGE, value, map);
+		}
+
+		FORCE_INLINE void counter(const char* name, const char* help, doubletype value, const char* map = null) {
+			sample(name, help, COUNTER, value, map);
+		}
+
+		// XXX: written to a temporary file and renamed into place (i.e. scrapers never see a partial file)
+		boolean write(const char* path) {
+			for (const Counter* c = s_counters; c != null; c = c->getNext()) {
+				counter(c->getName(), c->getHelp(), c->get());
+			}
+
+			char temp[PATH_MAX];
+			if (snprintf(temp, sizeof(temp), "%s.tmp", path) >= (inttype) sizeof(temp)) {
+				DEEP_LOG(WARN, STATS, "metrics: path too long, %s\n", path);
+				return false;
+			}
+
+			FILE* file = fopen(temp, "w");
+			if (file == null) {
+				DEEP_LOG(WARN, STATS, "metrics: unable to open %s\n", temp);
+				return false;
+			}
+
+			for (inttype i = 0; i < m_size; i++) {
+				Family& f = m_families[i];
+				fflush(f.m_stream);
+
+				fprintf(file, "# HELP %s %s\n# TYPE %s %s\n", f.m_name, f.m_help, f.m_name, typeToString(f.m_type));
+				fwrite(f.m_buffer, 1, f.m_size, file);
+			}
+
+			const boolean written = (ferror(file) == 0);
+			if ((fclose(file) != 0) || (written == false) || (rename(temp, path) != 0)) {
+				DEEP_LOG(WARN, STATS, "metrics: unable to write %s\n", path);
+				unlink(temp);
+				return false;
+			}
+
+			return true;
+		}
+};
+
+RealTimeMetrics::Counter* volatile RealTimeMetrics::s_counters = null;
+
+RealTimeMetrics::Counter RealTimeMetrics::SEGMENTS_PURGED("deep_segments_purged_total", "Segments purged from cache");
+RealTimeMetrics::Counter RealTimeMetrics::SEGMENTS_INDEXED("deep_segments_indexed_total", "Segments indexed to key files");
+RealTimeMetrics::Counter RealTimeMetrics::FILE_SYNCS("deep_file_syncs_total", "Durable file syncs performed");
+RealTimeMetrics::Counter RealTimeMetrics::FILE_BYTES_WRITTEN("deep_file_bytes_written_total", "Bytes written through measured files (before compression)");
+RealTimeMetrics::Counter RealTimeMetrics::SECONDARY_DEFERRED("deep_secondary_deferred_total", "Secondary changes buffered in segments that were not filled");
+
+} } } } } } // namespace
+
+#endif /*COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMETRICS_H_*/
@@ -0,0 +1,266 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMOUNT_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMOUNT_H_
+
+#include "cxx/io/File.h"
+#include "cxx/lang/Thread.h"
+#include "cxx/lang/Runnable.h"
+#include "cxx/util/Collections.h"
+#include "cxx/util/concurrent/Synchronize.h"
+
+#include "com/deepis/db/store/relative/core/RealTimeMap.h"
+#include "com/deepis/db/store/relative/core/RealTimeDiscover.h"
+
+using namespace cxx::io;
+using namespace cxx::lang;
+using namespace cxx::util;
+using namespace cxx::util::concurrent;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: mounts a batch of maps on a bounded set of threads, a primary and its secondaries mount in order on one thread
+template<typename K>
+class RealTimeMount {
+
+	private:
+		// XXX: one sorted listing per data directory, shared read-only by every map of the batch in that directory
+		struct Scan {
+			String m_directory;
+			ArrayList<String*>* m_list;
+
+			Scan(const String& directory, ArrayList<String*>* list):
+				m_directory(directory),
+				m_list(list) {
+			}
+
+			~Scan(void) {
+				delete m_list;
+			}
+		};
+
+		class Worker : public Runnable {
+
+			private:
+				RealTimeMount<K>* m_mount;
+
+			public:
+				Worker(void):
+					m_mount(null) {
+				}
+
+				FORCE_INLINE void setMount(RealTimeMount<K>* mount) {
+					m_mount = mount;
+				}
+
+				virtual void run(void) {
+					m_mount->work();
+				}
+		};
+
+		RealTimeMap<K>** m_maps;
+		inttype m_size;
+
+		ArrayList<RealTimeMap<K>*> m_units;
+		ArrayList<Scan*> m_scans;
+
+		volatile inttype m_next;
+		volatile inttype m_failed;
+		volatile inttype m_thrown;
+
+		inttype m_running;
+		Synchronizable m_done;
+
+		RealTimeMount(RealTimeMap<K>** maps, inttype size):
+			m_maps(maps),
+			m_size(size),
+			m_units(size),
+			m_scans(Properties::LIST_CAP, true),
+			m_next(0),
+			m_failed(0),
+			m_thrown(0),
+			m_running(0) {
+		}
+
+		static boolean contains(RealTimeMap<K>** maps, inttype size, const RealTime* map) {
+			for (inttype i = 0; i < size; i++) {
+				if (maps[i] == map) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		const ArrayList<String*>* scan(const RealTimeMap<K>* map) {
+			String dname;
+			String sname;
+			RealTimeDiscover<K>::directory(map, dname, sname);
+
+			for (inttype i = 0; i < m_scans.size(); i++) {
+				Scan* scan = m_scans.get(i);
+				if (scan->m_directory.equals(&dname) == true) {
+					return scan->m_list;
+				}
+			}
+
+			// XXX: a missing directory is left to discovery (i.e. same handling as a single mount)
+			ArrayList<String*>* list = File(dname).list();
+			if (list == null) {
+				return null;
+			}
+
+			Collections::sort(list);
+
+			m_scans.add(new Scan(dname, list));
+
+			return list;
+		}
+
+		void prepare(void) {
+			for (inttype i = 0; i < m_size; i++) {
+				RealTimeMap<K>* map = m_maps[i];
+
+				// XXX: secondaries follow their primary, unless the primary is already mounted
+				if ((map->m_primaryIndex == null) || (contains(m_maps, m_size, map->m_primaryIndex) == false)) {
+					m_units.add(map);
+				}
+
+				map->m_discoverScan = scan(map);
+			}
+		}
+
+		boolean mount(RealTimeMap<K>* map) {
+			boolean success = false;
+
+			try {
+				success = map->mount();
+
+			} catch (InvalidException) {
+				__sync_add_and_fetch(&m_thrown, 1);
+
+			} catch (IOException) {
+				__sync_add_and_fetch(&m_thrown, 1);
+			}
+
+			map->m_discoverScan = null;
+
+			if (success == false) {
+				__sync_add_and_fetch(&m_failed, 1);
+			}
+
+			return success;
+		}
+
+		void work(void) {
+			for (inttype i = __sync_fetch_and_add(&m_next, 1); i < m_units.size(); i = __sync_fetch_and_add(&m_next, 1)) {
+				RealTimeMap<K>* unit = m_units.get(i);
+				if ((mount(unit) == false) || (unit->m_primaryIndex != null)) {
+					continue;
+				}
+
+				for (inttype j = 0; j < m_size; j++) {
+					if (m_maps[j]->m_primaryIndex == unit) {
+						mount(m_maps[j]);
+					}
+				}
+			}
+
+			synchronized(m_done) {
+				if (--m_running == 0) {
+					m_done.notifyAll();
+				}
+			}
+		}
+
+		void await(void) {
+			synchronized(m_done) {
+				while (m_running != 0) {
+					m_done.wait();
+				}
+			}
+		}
+
+	public:
+		// XXX: threads include the caller, zero uses the configured work threads
+		static boolean concurrently(RealTimeMap<K>** maps, inttype size, inttype threads = 0) {
+			if (size == 0) {
+				return true;
+			}
+
+			if (threads <= 0) {
+				threads = Properties::getWorkThreads();
+			}
+
+			longtype start = System::currentTimeMillis();
+
+			RealTimeMount<K> batch(maps, size);
+			batch.prepare();
+
+			if (threads > batch.m_units.size()) {
+				threads = batch.m_units.size();
+			}
+
+			Worker* workers = new Worker[threads];
+
+			batch.m_running = threads;
+			for (inttype i = 1; i < threads; i++) {
+				workers[i].setMount(&batch);
+
+				Thread thread(&workers[i]);
+				thread.start();
+			}
+
+			batch.work();
+			batch.await();
+
+			delete [] workers;
+
+			// XXX: maps left unmounted (i.e. their primary failed) are failures too
+			for (inttype i = 0; i < size; i++) {
+				if (maps[i]->m_discoverScan != null) {
+					maps[i]->m_discoverScan = null;
+					batch.m_failed++;
+				}
+			}
+
+			DEEP_LOG(DEBUG, DCVRY, "mount: %d maps, %d units, %d threads, %d directories, elapsed: %lld, failed: %d\n", size, batch.m_units.size(), threads, batch.m_scans.size(), System::currentTimeMillis() - start, batch.m_failed);
+
+			if (batch.m_thrown != 0) {
+				DEEP_LOG(ERROR, OTHER, "Invalid concurrent mount: %d maps raised\n", batch.m_thrown);
+
+				throw InvalidException("Invalid concurrent mount");
+			}
+
+			return (batch.m_failed == 0);
+		}
+};
+
+} } } } } } // namespace
+
+#endif /*COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEMOUNT_H_*/
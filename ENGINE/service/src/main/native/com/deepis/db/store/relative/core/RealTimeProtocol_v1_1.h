@@ -2866,11 +2866,81 @@ struct RealTimeProtocol_v1_1_0_0 {
 		}
 	}
 
+	// XXX: encode values ahead of the stream file lock, the lock then only copies one block and assigns positions
+	FORCE_INLINE static inttype stageRealTime(RealTimeMap<K>* map, RealTimeConductor<K>* conductor, boolean cursor, boolean rolling) {
+		conductor->unstage();
+
+		// XXX: markers, rolls (i.e. compression and file changes) and closing null entries take the streaming path
+		if ((rolling == true) || (conductor->getMarkerCount() != 0) || (conductor->size() == 0)) {
+			return 0;
+		}
+
+		const inttype valueSize = map->m_share.getValueSize();
+
+		inttype length = 0;
+		for (inttype i = 0; i < conductor->size(); i++) {
+			Information* info = conductor->get(i)->getValue();
+			if (info->getLevel() < Information::LEVEL_ACTIVE) {
+				if (((i + 1) == conductor->size()) && (cursor == false)) {
+					return 0;
+				}
+
+				continue;
+			}
+
+			if (info->getFilePosition() != 0) {
+				continue;
+			}
+
+			if ((valueSize != -1) && (info->getSize() != (uinttype) valueSize)) {
+				return 0;
+			}
+
+			#ifdef DEEP_VALIDATE_DATA
+			length += sizeof(uinttype);
+			#endif
+
+			length += info->getSize();
+			if (length > Properties::DEFAULT_TRANSACTION_STAGING) {
+				return 0;
+			}
+		}
+
+		if (length == 0) {
+			return 0;
+		}
+
+		bytearray staging = conductor->stage(length);
+		for (inttype i = 0; i < conductor->size(); i++) {
+			Information* info = conductor->get(i)->getValue();
+			if ((info->getLevel() < Information::LEVEL_ACTIVE) || (info->getFilePosition() != 0)) {
+				continue;
+			}
+
+			#ifdef DEEP_VALIDATE_DATA
+			// XXX: same layout as RandomAccessFile::writeInt (i.e. big endian)
+			const uinttype crc = RealTimeValidate::simple(info->getData(), info->getSize());
+			*staging++ = (crc >> 24) & 0xff;
+			*staging++ = (crc >> 16) & 0xff;
+			*staging++ = (crc >>  8) & 0xff;
+			*staging++ = (crc >>  0) & 0xff;
+			#endif
+
+			memcpy(staging, info->getData(), info->getSize());
+			staging += info->getSize();
+		}
+
+		return length;
+	}
+
 	FORCE_INLINE static void commitRealTime(RealTimeMap<K>* map, RealTimeConductor<K>* conductor, boolean cursor, boolean purge) {
 		Transaction* tx = conductor->getTransaction();
 		const boolean rolling = tx->getRoll();
 		const boolean compressRoll = (rolling == true) && (map->m_valueCompressMode == true);
 
+		// XXX: outside of any lock
+		const inttype staged = stageRealTime(map, conductor, cursor, rolling);
+
 		nbyte tmpValue((const bytearray) null, 0);
 		// XXX: perform dynamic states consistently throughout the following
 		const boolean durable = (Properties::getDurable() == true);
@@ -2917,6 +2987,13 @@ struct RealTimeProtocol_v1_1_0_0 {
 				compressing = true;
 			}
 
+			// XXX: staged values are written as one block, unless that block would roll the stream file
+			longtype stagedPosition = vwfile->BufferedRandomAccessFile::getFilePointer();
+			const boolean staging = (staged != 0) && ((stagedPosition + staged) <= (longtype) map->getFileSize());
+			if (staging == true) {
+				vwfile->MeasuredRandomAccessFile::write(conductor->getStaging(), 0, staged);
+			}
+
 			inttype m = 0;
 			inttype i = 0;
 			boolean next = (i < conductor->size()) || (m < conductor->getMarkerCount());
@@ -3000,30 +3077,42 @@ struct RealTimeProtocol_v1_1_0_0 {
 					continue;
 				}
 
-				tmpValue.reassign((const bytearray) info->getData(), info->getSize());
-
-				if (compressing == true) {
-					info->setCompressedOffset(compressedOffset);
+				if (staging == true) {
 					info->setFileIndex(fileIndex);
-					info->setFilePosition(streamPosition);
+					info->setFilePosition(stagedPosition);
+
+					#ifdef DEEP_VALIDATE_DATA
+					stagedPosition += sizeof(uinttype);
+					#endif
+
+					stagedPosition += info->getSize();
+
 				} else {
-					info->setFileIndex(fileIndex);
-					info->setFilePosition(vwfile->BufferedRandomAccessFile::getFilePointer());
-				}
+					tmpValue.reassign((const bytearray) info->getData(), info->getSize());
 
-				if ((map->m_share.getValueSize() != -1) && (info->getSize() != (uinttype) map->m_share.getValueSize())) {
-					info->setSize(map->m_share.getValueSize());
-				}
+					if (compressing == true) {
+						info->setCompressedOffset(compressedOffset);
+						info->setFileIndex(fileIndex);
+						info->setFilePosition(streamPosition);
+					} else {
+						info->setFileIndex(fileIndex);
+						info->setFilePosition(vwfile->BufferedRandomAccessFile::getFilePointer());
+					}
 
-				#ifdef DEEP_VALIDATE_DATA
-				uinttype crc = RealTimeValidate::simple(tmpValue, info->getSize());
-				vwfile->MeasuredRandomAccessFile::writeInt(crc);
-				#endif
+					if ((map->m_share.getValueSize() != -1) && (info->getSize() != (uinttype) map->m_share.getValueSize())) {
+						info->setSize(map->m_share.getValueSize());
+					}
 
-				vwfile->MeasuredRandomAccessFile::write(&tmpValue, 0, info->getSize());
+					#ifdef DEEP_VALIDATE_DATA
+					uinttype crc = RealTimeValidate::simple(tmpValue, info->getSize());
+					vwfile->MeasuredRandomAccessFile::writeInt(crc);
+					#endif
 
-				if (compressing == true) {
-					compressedOffset += tmpValue.length;
+					vwfile->MeasuredRandomAccessFile::write(&tmpValue, 0, info->getSize());
+
+					if (compressing == true) {
+						compressedOffset += tmpValue.length;
+					}
 				}
 
 				RealTimeProtocol<V,K>::writeLrtEntry(map, lwfile, i, key, info, first, next, marking, cursor, purge, rolling, compressing, conductor->getTransactionId());
@@ -3046,6 +3135,12 @@ struct RealTimeProtocol_v1_1_0_0 {
 
 				throw InvalidException("Invalid info entry index in conductor");
 			}
+
+			if ((staging == true) && (stagedPosition != vwfile->BufferedRandomAccessFile::getFilePointer())) {
+				DEEP_LOG(ERROR, OTHER, "Invalid staged values: position=%lld, file=%lld, %s\n", stagedPosition, vwfile->BufferedRandomAccessFile::getFilePointer(), map->getFilePath());
+
+				throw InvalidException("Invalid staged values");
+			}
 			#endif
 
 			conductor->clearMarkers();
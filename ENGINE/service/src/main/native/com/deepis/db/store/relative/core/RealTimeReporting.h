@@ -55,6 +55,7 @@ struct RealTimeReporting {
 			counttype rolling;
 		};
 		counttype dirty;
+		counttype heat;
 
 		FORCE_INLINE PurgeReport() : 
 			purgeFlag(0),
@@ -64,11 +65,12 @@ struct RealTimeReporting {
 			indexState(0),
 			fragmentedKey(0),
 			reseeded(0),
-			dirty(0) {
+			dirty(0),
+			heat(0) {
 		}
 
 		FORCE_INLINE ulongtype total() const {
-			return purgeFlag + summary + purged + reindexing + indexState + fragmentedKey + reseeded + dirty;
+			return purgeFlag + summary + purged + reindexing + indexState + fragmentedKey + reseeded + dirty + heat;
 		}
 
 		FORCE_INLINE String toString() const {
@@ -87,6 +89,7 @@ struct RealTimeReporting {
 			appendString(inner, sizeof(inner), sep, total, "F", fragmentedKey);
 			appendString(inner, sizeof(inner), sep, total, "X", reseeded);
 			appendString(inner, sizeof(inner), sep, total, "D", dirty);
+			appendString(inner, sizeof(inner), sep, total, "H", heat);
 
 			const inttype count = snprintf(buf, sizeof(buf), "{%s }", inner);
 			return String(buf, count);
@@ -48,10 +48,12 @@
 #include "cxx/util/concurrent/atomic/AtomicInteger.h"
 #include "cxx/util/concurrent/atomic/AtomicBoolean.h"
 #include "cxx/util/concurrent/locks/ReentrantReadWriteLock.h"
+#include "cxx/util/concurrent/locks/LockProfile.h"
 
 #include "com/deepis/db/store/relative/core/RealTime.h"
 #include "com/deepis/db/store/relative/core/Properties.h"
 #include "com/deepis/db/store/relative/core/Transaction.h"
+#include "com/deepis/db/store/relative/core/RealTimeTrace.h"
 
 #include "com/deepis/db/store/relative/util/DynamicUtils.h"
 #include "com/deepis/db/store/relative/util/LockableHashMap.h"
@@ -418,6 +420,55 @@ class RealTimeResource : public Synchronizable, private Runnable {
 		}
 		#endif
 
+		#ifdef DEEP_LOCK_STATS
+		void lockStats(boolean log) {
+			LockProfile::setEnabled(Properties::getLockStatistics());
+
+			if ((log == true) && (LockProfile::getEnabled() == true)) {
+				for (LockProfile::Site* site = LockProfile::getSites(); (s_exit == false) && (site != null); site = site->getNext()) {
+					const ulongtype acquired = site->getAcquisitions();
+					if (acquired == 0) {
+						continue;
+					}
+
+					const ulongtype contended = site->getContended();
+
+					DEEP_LOG(DEBUG, STATS, "locks: %s, acquired: %llu, contended: %llu (%.2f%%), spins: %llu, wait p50/p99: %llu/%llu ns, hold p50/p99: %llu/%llu ns\n", site->getName(), acquired, contended, (contended * 100.0) / acquired, site->getSpins(), site->getWait(0.50), site->getWait(0.99), site->getHold(0.50), site->getHold(0.99));
+				}
+			}
+		}
+		#endif
+
+		void latencyStats(boolean log) {
+			if (log == true) {
+				if ((s_exit == false) && (s_rtReadWriteLock.readLock()->tryLock() == true)) {
+					copylist();
+
+					for (int i = 0; (s_exit == false) && (i < m_rtObjects.ArrayList<RealTime*>::size()); i++) {
+						RealTime* rt = m_rtObjects.ArrayList<RealTime*>::get(i);
+
+						const RealTimeLatency* latency = rt->getLatency();
+						if (latency == null) {
+							continue;
+						}
+
+						for (int o = 0; o < RealTimeLatency::OPERATIONS; o++) {
+							const RealTimeLatency::Operation operation = (RealTimeLatency::Operation) o;
+
+							const ulongtype count = latency->getCount(operation);
+							if (count == 0) {
+								continue;
+							}
+
+							DEEP_LOG(DEBUG, STATS, "latency: %s, %s: %llu, p50/p99/p999: %llu/%llu/%llu ns\n", rt->getFilePath(), RealTimeLatency::getName(operation), count, latency->getPercentile(operation, 0.50), latency->getPercentile(operation, 0.99), latency->getPercentile(operation, 0.999));
+						}
+					}
+
+					s_rtReadWriteLock.readLock()->unlock();
+				}
+			}
+		}
+
 		void seekStats(boolean log, boolean reset) {
 			if (log == true) {
 				if ((s_exit == false) && (s_rtReadWriteLock.readLock()->tryLock() == true)) {
@@ -438,6 +489,54 @@ class RealTimeResource : public Synchronizable, private Runnable {
 			}
 		}
 
+		void filterStats(boolean log, boolean reset) {
+			if (log == true) {
+				if ((s_exit == false) && (s_rtReadWriteLock.readLock()->tryLock() == true)) {
+					copylist();
+
+					ulongtype fN = 0, fP = 0;
+
+					for (int i = 0; (s_exit == false) && (i < m_rtObjects.ArrayList<RealTime*>::size()); i++) {
+						RealTime* rt = m_rtObjects.ArrayList<RealTime*>::get(i);
+
+						rt->filterStatistics(&fN, &fP, reset);
+					}
+
+					s_rtReadWriteLock.readLock()->unlock();
+
+					if ((fN + fP) != 0) {
+						DEEP_LOG(DEBUG, STATS, "filters: negative: %lld, false positive: %lld, rate: %.2f%% - reset: %d\n", fN, fP, (fP * 100.0) / (fN + fP), reset);
+					}
+				}
+			}
+		}
+
+		void metrics(boolean write) {
+			if (write == true) {
+				RealTimeMetrics metrics;
+
+				metrics.gauge("deep_cache_limit", "Cache pressure (i.e. 0 ignore, 1 neutral, 2 shallow, 3 immense, 4 extreme)", s_cacheLimit);
+				metrics.gauge("deep_cache_size_bytes", "Configured cache size", Properties::getCacheSize());
+				metrics.gauge("deep_cache_allocated_bytes", "Process allocated memory", Memory::getProcessAllocatedBytes());
+				metrics.gauge("deep_cache_freelist_bytes", "Allocator free list memory", Memory::getFreeListBytes());
+				metrics.gauge("deep_cache_fragmented", "Cache memory considered fragmented", s_fragmented);
+
+				if ((s_exit == false) && (s_rtReadWriteLock.readLock()->tryLock() == true)) {
+					copylist();
+
+					metrics.gauge("deep_maps", "Mounted maps", m_rtObjects.ArrayList<RealTime*>::size());
+
+					for (int i = 0; (s_exit == false) && (i < m_rtObjects.ArrayList<RealTime*>::size()); i++) {
+						m_rtObjects.ArrayList<RealTime*>::get(i)->metricStatistics(&metrics);
+					}
+
+					s_rtReadWriteLock.readLock()->unlock();
+				}
+
+				metrics.write(Properties::getMetricsPath());
+			}
+		}
+
 		void workTasks(boolean cycle, inttype thread) {
 			boolean force = (cycle == true) || (s_theTasks[thread].m_continue == true) || (s_theTasks[thread].m_reorganize == true);
 
@@ -630,14 +729,27 @@ class RealTimeResource : public Synchronizable, private Runnable {
 		void sync(/* TODO: longtype delay */) {
 
 			longtype interval = Properties::getDurableSyncInterval();
-			if ((Properties::getDurable() == false) || (interval == 0)) {
+			if (Properties::getDurable() == false) {
 				Thread::sleep(1000 /* delay */);
 				return;
 			}
 
+			// XXX: committers lead their own syncs, only asynchronous commits (see Transaction::commitAsync) need one led here
+			if (interval == 0) {
+				if (MeasuredRandomAccessFile::awaitSynchronizeGlobally(1000 /* delay */) == true) {
+					RealTimeTrace::Span span("sync", 0 /* all maps */);
+
+					span.setCounts("elapsed", MeasuredRandomAccessFile::performSynchronizeGlobally(false /* decrement */), "interval", interval);
+				}
+
+				return;
+			}
+
 			Thread::sleep(interval /* durable sync interval */);
 
-			MeasuredRandomAccessFile::performSynchronizeGlobally(false /* decrement */);
+			RealTimeTrace::Span span("sync", 0 /* all maps */);
+
+			span.setCounts("elapsed", MeasuredRandomAccessFile::performSynchronizeGlobally(false /* decrement */), "interval", interval);
 		}
 
 		void run(void) {
@@ -695,8 +807,21 @@ class RealTimeResource : public Synchronizable, private Runnable {
 						ioStats((i % Properties::DEFAULT_CACHE_STATS_MODE) == 0);
 						#endif
 
+						#ifdef DEEP_LOCK_STATS
+						lockStats((i % Properties::DEFAULT_CACHE_STATS_MODE) == 0);
+						#endif
+
+						if (Properties::getLatencyStatistics() == true) {
+							latencyStats((i % Properties::DEFAULT_CACHE_STATS_MODE) == 0);
+						}
+
 						if (Properties::getSeekStatistics() == true) {
 							seekStats((i % Properties::getSeekStatisticsDisplayMode()) == 0, (i % Properties::getSeekStatisticsResetMode()) == 0);
+							filterStats((i % Properties::getSeekStatisticsDisplayMode()) == 0, (i % Properties::getSeekStatisticsResetMode()) == 0);
+						}
+
+						if (*Properties::getMetricsPath() != '\0') {
+							metrics((i % Properties::DEFAULT_CACHE_METRICS_MODE) == 0);
 						}
 
 					} else /* if (indexing, reorging, etc...) */ {
@@ -785,6 +910,13 @@ class RealTimeResource : public Synchronizable, private Runnable {
 			#endif
 		}
 
+		// XXX: run the next work cycle now instead of waiting out the cache cycle (e.g. hot set warming)
+		FORCE_INLINE static void continueTasks(void) {
+			for (int i = 0; i < Properties::getWorkThreads(); i++) {
+				s_theTasks[i].m_continue = true;
+			}
+		}
+
 		FORCE_INLINE static longtype currentTimeMillis(void) {
 			return s_lastTimeStamp;
 		}
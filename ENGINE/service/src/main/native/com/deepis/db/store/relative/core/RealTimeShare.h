@@ -35,6 +35,8 @@
 #include "cxx/util/ArrayList.h"
 
 #ifdef DEEP_USERLOCK
+	#include "cxx/util/concurrent/locks/FutexLock.h"
+	#include "cxx/util/concurrent/locks/ProfiledLock.h"
 	#include "cxx/util/concurrent/locks/UserSpaceLock.h"
 #else
 	#include "cxx/util/concurrent/locks/ReentrantLock.h"
@@ -96,7 +98,9 @@ class RealTimeShare {
 
 		static inttype s_fileLimitIndex;
 		#ifdef DEEP_USERLOCK
-		static UserSpaceLock s_fileLimitLock;
+		// XXX: held across file open/close, waiters park rather than spin (see FutexLock)
+		CXX_LOCK_SITE(FileLimitLockSite, "file limit")
+		static CXX_PROFILED_LOCK(FutexLock, FileLimitLockSite) s_fileLimitLock;
 		#else
 		static ReentrantLock s_fileLimitLock;
 		#endif
@@ -534,7 +538,7 @@ class RealTimeShare {
 
 inttype RealTimeShare::s_fileLimitIndex = 0;
 #ifdef DEEP_USERLOCK
-UserSpaceLock RealTimeShare::s_fileLimitLock;
+CXX_PROFILED_LOCK(FutexLock, RealTimeShare::FileLimitLockSite) RealTimeShare::s_fileLimitLock;
 #else
 ReentrantLock RealTimeShare::s_fileLimitLock(false);
 #endif
@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMETRACE_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMETRACE_H_
+
+#include <time.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "cxx/lang/types.h"
+#include "cxx/util/Logger.h"
+
+using namespace cxx::lang;
+using namespace cxx::util;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: always-on timeline of background work (purge, index, checkpoint, etc), one fixed ring of spans per thread
+class RealTimeTrace {
+
+	public:
+		static const uinttype EVENTS = 1024;
+
+		struct Event {
+			const char* m_name;
+			longtype m_map;
+			ulongtype m_begin;
+			ulongtype m_end;
+			const char* m_firstName;
+			ulongtype m_first;
+			const char* m_secondName;
+			ulongtype m_second;
+		};
+
+		// XXX: single writer (owning thread), dump reads whatever has not been overwritten meanwhile
+		struct Ring {
+			Event m_events[EVENTS];
+			volatile ulongtype m_position;
+			longtype m_thread;
+			Ring* m_next;
+		};
+
+		// XXX: records a span for the scope, counts are attached by the caller before the scope ends
+		class Span {
+
+			private:
+				const char* m_name;
+				longtype m_map;
+				ulongtype m_begin;
+				const char* m_firstName;
+				ulongtype m_first;
+				const char* m_secondName;
+				ulongtype m_second;
+
+			public:
+				FORCE_INLINE Span(const char* name, longtype map):
+					m_name(name),
+					m_map(map),
+					m_begin(nanoTime()),
+					m_firstName("count"),
+					m_first(0),
+					m_secondName("total"),
+					m_second(0) {
+				}
+
+				FORCE_INLINE ~Span(void) {
+					RealTimeTrace::record(m_name, m_map, m_begin, nanoTime(), m_firstName, m_first, m_secondName, m_second);
+				}
+
+				// XXX: names are expected to be literals (i.e. only the pointer is recorded)
+				FORCE_INLINE void setCounts(const char* firstName, ulongtype first, const char* secondName, ulongtype second) {
+					m_firstName = firstName;
+					m_first = first;
+					m_secondName = secondName;
+					m_second = second;
+				}
+		};
+
+	private:
+		static Ring* volatile s_rings;
+		static __thread Ring* s_ring;
+
+		FORCE_INLINE static Ring* getRing(void) {
+			Ring* ring = s_ring;
+			if (ring == null) {
+				// XXX: rings live for the process (i.e. spans of exited threads remain visible to dump)
+				ring = new Ring();
+				ring->m_position = 0;
+				ring->m_thread = (longtype) syscall(SYS_gettid);
+
+				do {
+					ring->m_next = s_rings;
+				} while (__sync_bool_compare_and_swap(&s_rings, ring->m_next, ring) == false);
+
+				s_ring = ring;
+			}
+
+			return ring;
+		}
+
+	public:
+		FORCE_INLINE static ulongtype nanoTime(void) {
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			return (((ulongtype) ts.tv_sec) * 1000000000ULL) + ts.tv_nsec;
+		}
+
+		FORCE_INLINE static void record(const char* name, longtype map, ulongtype begin, ulongtype end, const char* firstName, ulongtype first, const char* secondName, ulongtype second) {
+			Ring* ring = getRing();
+
+			const ulongtype position = ring->m_position;
+			Event& event = ring->m_events[position % EVENTS];
+
+			event.m_name = name;
+			event.m_map = map;
+			event.m_begin = begin;
+			event.m_end = end;
+			event.m_firstName = firstName;
+			event.m_first = first;
+			event.m_secondName = secondName;
+			event.m_second = second;
+
+			__sync_synchronize();
+			ring->m_position = position + 1;
+		}
+
+		// XXX: export every ring in chrome trace-event format (i.e. load in chrome://tracing or perfetto), returns spans written or -1
+		static longtype dump(const char* path) {
+			FILE* file = fopen(path, "w");
+			if (file == null) {
+				DEEP_LOG(WARN, OTHER, "trace: unable to open %s\n", path);
+				return -1;
+			}
+
+			const longtype pid = (longtype) getpid();
+			const char* sep = "";
+			longtype spans = 0;
+
+			fprintf(file, "{\"traceEvents\":[");
+
+			for (Ring* ring = s_rings; ring != null; ring = ring->m_next) {
+				const ulongtype last = ring->m_position;
+				__sync_synchronize();
+
+				const ulongtype first = (last > EVENTS) ? (last - EVENTS) : 0;
+
+				for (ulongtype i = first; i < last; i++) {
+					const Event event = ring->m_events[i % EVENTS];
+
+					// XXX: slot is being (or was) reused while reading
+					__sync_synchronize();
+					if ((ring->m_position - i) >= EVENTS) {
+						continue;
+					}
+
+					fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"background\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lld,\"tid\":%lld,\"args\":{\"map\":%lld,\"%s\":%llu,\"%s\":%llu}}", sep, event.m_name, event.m_begin / 1000.0, (event.m_end - event.m_begin) / 1000.0, pid, ring->m_thread, event.m_map, event.m_firstName, event.m_first, event.m_secondName, event.m_second);
+
+					sep = ",";
+					spans++;
+				}
+			}
+
+			fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+			if (ferror(file) != 0) {
+				spans = -1;
+			}
+
+			fclose(file);
+
+			DEEP_LOG(DEBUG, STATS, "trace: %s, spans: %lld\n", path, spans);
+
+			return spans;
+		}
+};
+
+RealTimeTrace::Ring* volatile RealTimeTrace::s_rings = null;
+__thread RealTimeTrace::Ring* RealTimeTrace::s_ring = null;
+
+} } } } } } // namespace
+
+#endif /*COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMETRACE_H_*/
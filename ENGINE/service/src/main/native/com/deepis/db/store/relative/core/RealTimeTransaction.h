@@ -74,6 +74,10 @@ class RealTimeConductor : public Conductor {
 		BasicArray<Marker*> m_markers;
 		inttype m_size;
 
+		// XXX: commit values encoded outside the stream file lock (see RealTimeProtocol_v1_1_0_0::stageRealTime)
+		nbyte m_staging;
+		inttype m_staged;
+
 	public:
 		inline void referenceFiles(MeasuredRandomAccessFile* file) {
 			Transaction* tx = getTransaction();
@@ -102,7 +106,9 @@ class RealTimeConductor : public Conductor {
 			m_operations(Properties::LIST_CAP, true),
 			m_primaryMap(map),
 			m_markers(0, true),
-			m_size(0) {
+			m_size(0),
+			m_staging((inttype) 0),
+			m_staged(0) {
 
 			m_contexts.add(m_primaryMap->getThreadContext());
 
@@ -150,6 +156,28 @@ class RealTimeConductor : public Conductor {
 			m_markers.clear();
 		}
 
+		FORCE_INLINE bytearray stage(inttype length) {
+			if (m_staging.length < length) {
+				m_staging.realloc(length);
+			}
+
+			m_staged = length;
+
+			return m_staging;
+		}
+
+		FORCE_INLINE void unstage(void) {
+			m_staged = 0;
+		}
+
+		FORCE_INLINE const nbyte* getStaging(void) const {
+			return &m_staging;
+		}
+
+		FORCE_INLINE inttype getStaged(void) const {
+			return m_staged;
+		}
+
 		FORCE_INLINE SegMapEntry* get(inttype index) const {
 			return m_operations.get(index);
 		}
@@ -245,6 +273,10 @@ class RealTimeConductor : public Conductor {
 			return path;
 		}
 
+		FORCE_INLINE RealTimeLatency* getLatency(void) {
+			return m_primaryMap->getLatency();
+		}
+
 		FORCE_INLINE void clear(void) {
 			m_mergeOptimize = 0;
 			m_createStats = 0;
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEWRITEBATCH_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEWRITEBATCH_H_
+
+#include "cxx/util/ArrayList.h"
+#include "cxx/util/Collections.h"
+#include "cxx/util/Comparator.h"
+
+#include "com/deepis/db/store/relative/core/RealTime.h"
+
+using namespace cxx::util;
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+template <typename K> class RealTimeMap;
+
+// XXX: collects puts and removes applied as one unit by RealTimeMap::write (keys and values are copied)
+template<typename K>
+class RealTimeWriteBatch {
+
+	private:
+		struct Operation {
+			K m_key;
+			nbyte* m_value;
+			RealTime::WriteOption m_option;
+			inttype m_sequence;
+
+			Operation(K key, nbyte* value, RealTime::WriteOption option, inttype sequence):
+				m_key(key),
+				m_value(value),
+				m_option(option),
+				m_sequence(sequence) {
+			}
+		};
+
+		// XXX: key order, insertion order within a key (i.e. the last operation on a key wins)
+		class OperationCmp {
+
+			private:
+				const Comparator<K>* m_comparator;
+
+			public:
+				OperationCmp(const Comparator<K>* comparator):
+					m_comparator(comparator) {
+				}
+
+				FORCE_INLINE int compare(const Operation* o1, const Operation* o2) const {
+					int cmp = m_comparator->compare(o1->m_key, o2->m_key);
+					if (cmp == 0) {
+						cmp = o1->m_sequence - o2->m_sequence;
+					}
+
+					return cmp;
+				}
+		};
+
+		RealTimeMap<K>* m_map;
+		ArrayList<Operation*> m_operations;
+		inttype m_failed;
+
+		FORCE_INLINE void add(const K key, const nbyte* value, RealTime::WriteOption option) {
+			nbyte* copy = null;
+			if (value != null) {
+				copy = new nbyte(value->length);
+				memcpy((bytearray) *copy, (bytearray) *value, value->length);
+			}
+
+			m_operations.add(new Operation(m_map->m_keyBuilder->cloneKey(key), copy, option, m_operations.size()));
+		}
+
+		FORCE_INLINE void sort(const Comparator<K>* comparator) {
+			OperationCmp cmp(comparator);
+			Collections::template mergeSort2<Operation*, ArrayList<Operation*>, OperationCmp>(&m_operations, &cmp);
+		}
+
+	public:
+		RealTimeWriteBatch(RealTimeMap<K>* map, inttype capacity = 64):
+			m_map(map),
+			m_operations(capacity),
+			m_failed(-1) {
+		}
+
+		virtual ~RealTimeWriteBatch(void) {
+			clear();
+		}
+
+		FORCE_INLINE void put(const K key, const nbyte* value, RealTime::WriteOption option = RealTime::STANDARD) {
+			if ((option != RealTime::STANDARD) && (option != RealTime::UNIQUE) && (option != RealTime::EXISTING)) {
+				DEEP_LOG(ERROR, OTHER, "Invalid batch put: option %d not supported, %s\n", option, m_map->getFilePath());
+
+				throw InvalidException("Invalid batch put: option not supported");
+			}
+
+			add(key, value, option);
+		}
+
+		FORCE_INLINE void remove(const K key) {
+			add(key, null, RealTime::STANDARD);
+		}
+
+		FORCE_INLINE void clear(void) {
+			for (inttype i = 0; i < m_operations.size(); i++) {
+				Operation* operation = m_operations.get(i);
+
+				Converter<K>::destroy(operation->m_key);
+				delete operation->m_value;
+				delete operation;
+			}
+
+			m_operations.clear();
+			m_failed = -1;
+		}
+
+		FORCE_INLINE inttype size(void) const {
+			return m_operations.size();
+		}
+
+		// XXX: insertion index of the operation that failed the last write (see RealTimeMap::getErrorCode), otherwise -1
+		FORCE_INLINE inttype getFailed(void) const {
+			return m_failed;
+		}
+
+	friend class RealTimeMap<K>;
+};
+
+} } } } } } // namespace
+
+#endif /*COM_DEEPIS_DB_STORE_RELATIVE_CORE_REALTIMEWRITEBATCH_H_*/
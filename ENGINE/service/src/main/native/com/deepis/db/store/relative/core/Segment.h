@@ -38,8 +38,11 @@
 	#include "cxx/util/concurrent/locks/ReentrantLock.h"
 #endif
 
+#include "cxx/util/concurrent/locks/ProfiledLock.h"
+
 #include "com/deepis/db/store/relative/core/Properties.h"
 #include "com/deepis/db/store/relative/core/Information.h"
+#include "com/deepis/db/store/relative/core/SegmentFilter.h"
 #include "com/deepis/db/store/relative/core/RealTimeTypes.h"
 #include "com/deepis/db/store/relative/core/RealTimeLocality.h"
 
@@ -81,6 +84,8 @@ namespace com { namespace deepis { namespace db { namespace store { namespace re
 template<typename K>
 struct InfoReference;
 
+CXX_LOCK_SITE(SegmentLockSite, "segment")
+
 template<typename K>
 class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 
@@ -88,7 +93,7 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 		#if 0 /* DEEP_USERLOCK */
 		UserSpaceLock m_lock;
 		#else
-		ReentrantLock m_lock;
+		CXX_PROFILED_LOCK(ReentrantLock, SegmentLockSite) m_lock;
 		#endif
 
 		#if 0
@@ -110,9 +115,15 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 
 		ubytetype m_fragmentCount;
 
+		// XXX: saturating point access count, halved on each hot set record and purge pass (see RealTimeMap::recordHotSet, purgeCacheManagement)
+		ubytetype m_heat;
+
 		bytearray m_zipData;
 		inttype m_zipSize;
 
+		// XXX: resident while purged (see RealTimeMap::purgeSegment)
+		SegmentFilter* m_filter;
+
 		inttype m_uncompressedSize;
 
 		// XXX: this is the last (most recent) lrt/vrt locality that may have influenced the indexing of this segment
@@ -267,8 +278,10 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 			m_pagingIndexes(&USHORT_CMP),
 			m_streamIndexes(&STREAM_REF_CMP, TreeSet<StreamReference*>::INITIAL_ORDER, true /* delete values */),
 			m_fragmentCount(0),
+			m_heat(0),
 			m_zipData(null),
 			m_zipSize(0),
+			m_filter(null),
 			m_uncompressedSize(0),
 			m_indexLocality(RealTimeLocality::LOCALITY_NONE),
 			m_summarizedLocality(RealTimeLocality::LOCALITY_NONE),
@@ -299,6 +312,9 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 			if (m_zipData != null) {
 				free(m_zipData);
 			}
+			if (m_filter != null) {
+				delete m_filter;
+			}
 		}
 
 		FORCE_INLINE void setStateFlags(ubytetype flags) {
@@ -338,6 +354,12 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 		}
 
 		FORCE_INLINE void setPurged(boolean flag) {
+			// XXX: filter only describes the keyset paged out at purge time
+			if ((flag == false) && (m_filter != null)) {
+				delete m_filter;
+				m_filter = null;
+			}
+
 			return setFlag<SEGMENT_FLAG_PURGED>(m_stateFlags, flag);
 		}
 
@@ -1096,6 +1118,35 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 			m_zipSize = 0;
 		}
 
+		FORCE_INLINE void setFilter(SegmentFilter* filter) {
+			if (m_filter != null) {
+				delete m_filter;
+			}
+
+			m_filter = filter;
+		}
+
+		FORCE_INLINE const SegmentFilter* getFilter(void) const {
+			return m_filter;
+		}
+
+		FORCE_INLINE void incrementHeat(void) {
+			if (m_heat != 0xff) {
+				m_heat++;
+			}
+		}
+
+		FORCE_INLINE ubytetype coolHeat(void) {
+			ubytetype heat = m_heat;
+			m_heat = heat >> 1;
+
+			return heat;
+		}
+
+		FORCE_INLINE ubytetype getHeat(void) const {
+			return m_heat;
+		}
+
 		FORCE_INLINE void resetStreamIndexes(void) {
 			m_streamIndexes.clear();
 		}
@@ -1107,6 +1158,8 @@ class Segment : public RealTimeTypes<K>::SegTreeMap /*, public Lockable */ {
 		}
 
 		FORCE_INLINE void resetFlags(void) {
+			setFilter(null);
+
 			setFlags(m_stateFlags, 0);
 			setFlags(m_extraFlags, 0);
 			setFlags(m_moreFlags, 0);
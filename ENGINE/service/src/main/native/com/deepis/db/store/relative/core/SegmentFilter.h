@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef COM_DEEPIS_DB_STORE_RELATIVE_CORE_SEGMENTFILTER_H_
+#define COM_DEEPIS_DB_STORE_RELATIVE_CORE_SEGMENTFILTER_H_
+
+#include <string.h>
+
+#include "cxx/lang/types.h"
+
+namespace com { namespace deepis { namespace db { namespace store { namespace relative { namespace core {
+
+// XXX: bloom filter over the keys of a purged segment (i.e. no false negatives, definite misses skip the irt)
+class SegmentFilter {
+
+	private:
+		uinttype m_mask;
+		ubytetype m_probes;
+		ulongtype* m_words;
+
+		FORCE_INLINE static ulongtype mix(inttype hash) {
+			// XXX: key hash codes can be identities (e.g. primitives), spread them before probing
+			ulongtype h = (ulongtype) (uinttype) hash;
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ULL;
+			h ^= h >> 33;
+
+			return h;
+		}
+
+	public:
+		SegmentFilter(inttype entries, inttype bitsPerKey) :
+			m_mask(0),
+			m_probes(0),
+			m_words(null) {
+
+			ulongtype bits = 64;
+			while ((bits < ((ulongtype) entries * bitsPerKey)) && (bits < 0x80000000ULL)) {
+				bits <<= 1;
+			}
+
+			m_mask = (uinttype) (bits - 1);
+
+			// XXX: optimal probe count is bitsPerKey * ln(2)
+			m_probes = (ubytetype) ((bitsPerKey * 69) / 100);
+			if (m_probes < 1) {
+				m_probes = 1;
+
+			} else if (m_probes > 16) {
+				m_probes = 16;
+			}
+
+			m_words = new ulongtype[bits / 64];
+			memset(m_words, 0, (bits / 64) * sizeof(ulongtype));
+		}
+
+		~SegmentFilter(void) {
+			delete [] m_words;
+		}
+
+		FORCE_INLINE void add(inttype hash) {
+			ulongtype h = mix(hash);
+			uinttype h1 = (uinttype) h;
+			uinttype h2 = ((uinttype) (h >> 32)) | 1;
+
+			for (ubytetype i = 0; i < m_probes; i++) {
+				uinttype bit = (h1 + (i * h2)) & m_mask;
+				m_words[bit >> 6] |= (1ULL << (bit & 63));
+			}
+		}
+
+		FORCE_INLINE boolean contains(inttype hash) const {
+			ulongtype h = mix(hash);
+			uinttype h1 = (uinttype) h;
+			uinttype h2 = ((uinttype) (h >> 32)) | 1;
+
+			for (ubytetype i = 0; i < m_probes; i++) {
+				uinttype bit = (h1 + (i * h2)) & m_mask;
+				if ((m_words[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		FORCE_INLINE uinttype size(void) const {
+			return ((m_mask + 1) / 8) + sizeof(SegmentFilter);
+		}
+};
+
+} } } } } } // namespace
+
+#endif /* COM_DEEPIS_DB_STORE_RELATIVE_CORE_SEGMENTFILTER_H_ */
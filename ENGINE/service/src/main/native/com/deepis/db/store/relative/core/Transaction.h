@@ -38,6 +38,9 @@
 #include "cxx/util/concurrent/locks/ReentrantLock.h"
 
 //#ifdef DEEP_USERLOCK
+	#include "cxx/util/concurrent/locks/FutexLock.h"
+	#include "cxx/util/concurrent/locks/ProfiledLock.h"
+	#include "cxx/util/concurrent/locks/QueueLock.h"
 	#include "cxx/util/concurrent/locks/UserSpaceLock.h"
 //#else
 	//#include "cxx/util/concurrent/locks/ReentrantLock.h"
@@ -52,6 +55,7 @@
 #include "com/deepis/db/store/relative/core/Properties.h"
 #include "com/deepis/db/store/relative/core/Information.h"
 #include "com/deepis/db/store/relative/core/RealTimeAtomic.h"
+#include "com/deepis/db/store/relative/core/RealTimeLatency.h"
 
 using namespace cxx::util;
 using namespace cxx::util::concurrent;
@@ -81,6 +85,9 @@ class Conductor {
 
 		ulongtype m_transactionId;
 
+		// XXX: start of a durable two phase commit (see RealTimeLatency::COMMIT)
+		ulongtype m_commitTicks;
+
 	public:
 		inttype m_mergeOptimize;
 		inttype m_createStats;
@@ -102,7 +109,8 @@ class Conductor {
 			m_reserved(false),
 			m_reservedKey(0),
 			m_reservedBlock(0),
-			m_transactionId(0) {
+			m_transactionId(0),
+			m_commitTicks(0) {
 
 			m_mergeOptimize = 0;
 			m_createStats = 0;
@@ -197,9 +205,18 @@ class Conductor {
 			return m_transactionId;
 		}
 
+		FORCE_INLINE void setCommitTicks(ulongtype ticks) {
+			m_commitTicks = ticks;
+		}
+
+		FORCE_INLINE ulongtype getCommitTicks(void) const {
+			return m_commitTicks;
+		}
+
 		virtual inttype size(void) const = 0;
 
 		virtual const char* getFilePath(void) const = 0; 
+		virtual RealTimeLatency* getLatency(void) = 0;
 
 		virtual void index(inttype index, ConcurrentObject* context) = 0;
 		virtual void clearIndex(void) = 0;
@@ -237,8 +254,11 @@ class Transaction : public SynchronizableSafe {
 		Conductor* m_hotConductor;
 		longtype m_hotIdentifier;
 
+		CXX_LOCK_SITE(ConductorLockSite, "conductor")
+		CXX_LOCK_SITE(TransactionLockSite, "transaction")
+
 		//#ifdef DEEP_USERLOCK
-		UserSpaceLock m_conductorLock;
+		CXX_PROFILED_LOCK(FutexLock, ConductorLockSite) m_conductorLock;
 		//#else
 		//ReentrantLock m_conductorLock;
 		//#endif
@@ -278,7 +298,8 @@ class Transaction : public SynchronizableSafe {
 		static uinttype s_viewpointSequence;
 
 		#ifdef DEEP_USERLOCK
-		static UserSpaceLock s_transactionLock;
+		// XXX: taken by every transaction create/destroy, queue hand-off keeps it fair across many threads
+		static CXX_PROFILED_LOCK(QueueLock, TransactionLockSite) s_transactionLock;
 		#else
 		static ReentrantLock s_transactionLock;
 		#endif
@@ -1000,7 +1021,7 @@ class Transaction : public SynchronizableSafe {
 			*/
 		}
 
-		FORCE_INLINE void commit(shorttype level) {
+		FORCE_INLINE void commit(shorttype level, MeasuredRandomAccessFile::Ticket* ticket = null /* see commitAsync */) {
 			if (getDirty() == true) {
 
 				boolean requiresACP = RealTimeAtomic::useAtomicCommit();
@@ -1050,7 +1071,10 @@ class Transaction : public SynchronizableSafe {
 
 					#ifdef DEEP_SYNCHRONIZATION_GROUPING
 					if (Properties::getDurable() == true) {
-						MeasuredRandomAccessFile::planSynchronizeGlobally();
+						// XXX: asynchronous commits do not take part in the leader election, the ticket is queued instead
+						if (ticket == null) {
+							MeasuredRandomAccessFile::planSynchronizeGlobally();
+						}
 
 						ConductorEntrySetIterator* iter = (ConductorEntrySetIterator*) m_conductorSet.reset();
 						while (iter->ConductorEntrySetIterator::hasNext()) {
@@ -1082,7 +1106,11 @@ class Transaction : public SynchronizableSafe {
 							MeasuredRandomAccessFile::prepareSynchronizeGlobally(atomicCommit->getFile());
 						}
 
-						if (Properties::getDurableSyncInterval() == 0) {
+						if (ticket != null) {
+							MeasuredRandomAccessFile::requestSynchronizeGlobally(ticket);
+							ticket = null;
+
+						} else if (Properties::getDurableSyncInterval() == 0) {
 							boolean holddown = false;
 							if (Properties::getDurableHoldDownTime() != 0) {
 								for (int i = 0; (i < (s_maxIdentifier + 1)); i++) {
@@ -1098,7 +1126,21 @@ class Transaction : public SynchronizableSafe {
 								}
 							}
 
+							const ulongtype start = RealTimeLatency::ticks();
+
 							longtype time = MeasuredRandomAccessFile::performSynchronizeGlobally(true /* decrement */, holddown);
+
+							// XXX: the sync is shared by every map in the transaction, charge each of them for the wait
+							const ulongtype ticks = RealTimeLatency::ticks() - start;
+
+							iter = (ConductorEntrySetIterator*) m_conductorSet.reset();
+							while (iter->ConductorEntrySetIterator::hasNext()) {
+								RealTimeLatency* latency = iter->ConductorEntrySetIterator::next()->getValue()->getLatency();
+								if (latency != null) {
+									latency->record(RealTimeLatency::SYNC, ticks);
+								}
+							}
+
 							if (time < Properties::getDurableHoldDownThreshold()) {
 								m_holddown = false;
 
@@ -1155,6 +1197,16 @@ class Transaction : public SynchronizableSafe {
 			} else {
 				m_level = level - 1;
 			}
+
+			// XXX: nothing was queued (non-durable, nested, empty or ungrouped commit), hence already as durable as it gets
+			if (ticket != null) {
+				ticket->complete();
+			}
+		}
+
+		// XXX: returns once the commit is visible, the ticket is completed by the sync leader once it is on disk
+		FORCE_INLINE void commitAsync(shorttype level, MeasuredRandomAccessFile::Ticket* ticket) {
+			commit(level, ticket);
 		}
 
 		FORCE_INLINE void rollback(shorttype level) {
@@ -1196,7 +1248,7 @@ uinttype Transaction::s_viewpointMinimum(0);
 uinttype Transaction::s_viewpointSequence(0);
 
 #ifdef DEEP_USERLOCK
-UserSpaceLock Transaction::s_transactionLock;
+CXX_PROFILED_LOCK(QueueLock, Transaction::TransactionLockSite) Transaction::s_transactionLock;
 #else
 ReentrantLock Transaction::s_transactionLock;
 #endif
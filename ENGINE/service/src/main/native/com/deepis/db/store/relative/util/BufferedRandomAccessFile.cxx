@@ -25,6 +25,10 @@
  *    exception statement from all source files in the program, then also delete
  *    it in the license file.
  */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+
 #include "cxx/lang/System.h"
 
 #include "com/deepis/db/store/relative/util/BufferedRandomAccessFile.h"
@@ -55,7 +59,23 @@ BufferedRandomAccessFile::BufferedRandomAccessFile(inttype bufferSize):
 	m_lastUncompressedBlockLength(0),
 	#endif
 	m_inZstream(null),
-	m_refill(false) {
+	m_refill(false),
+	m_mapped(false),
+	m_accessMode(ACCESS_RANDOM),
+	m_mapData(null),
+	m_mapLength(0),
+	m_mapSize(0),
+	m_heapData(null),
+	m_heapLength(0),
+	m_direct(false),
+	m_directFileno(-1),
+	m_directIndex(0),
+	m_directFill(0),
+	m_directSynced(0),
+	m_directBase(-1) {
+
+	m_directData[0] = m_directData[1] = null;
+	m_directPending[0] = m_directPending[1] = false;
 }
 
 BufferedRandomAccessFile::BufferedRandomAccessFile(const char* path, const char* mode, inttype bufferSize):
@@ -80,7 +100,23 @@ BufferedRandomAccessFile::BufferedRandomAccessFile(const char* path, const char*
 	m_lastUncompressedBlockLength(0),
 	#endif
 	m_inZstream(null),
-	m_refill(false) {
+	m_refill(false),
+	m_mapped(false),
+	m_accessMode(ACCESS_RANDOM),
+	m_mapData(null),
+	m_mapLength(0),
+	m_mapSize(0),
+	m_heapData(null),
+	m_heapLength(0),
+	m_direct(false),
+	m_directFileno(-1),
+	m_directIndex(0),
+	m_directFill(0),
+	m_directSynced(0),
+	m_directBase(-1) {
+
+	m_directData[0] = m_directData[1] = null;
+	m_directPending[0] = m_directPending[1] = false;
 }
 
 BufferedRandomAccessFile::BufferedRandomAccessFile(const File* file, const char* mode, inttype bufferSize):
@@ -104,7 +140,23 @@ BufferedRandomAccessFile::BufferedRandomAccessFile(const File* file, const char*
 	m_lastUncompressedBlockLength(0),
 	#endif
 	m_inZstream(null),
-	m_refill(false) {
+	m_refill(false),
+	m_mapped(false),
+	m_accessMode(ACCESS_RANDOM),
+	m_mapData(null),
+	m_mapLength(0),
+	m_mapSize(0),
+	m_heapData(null),
+	m_heapLength(0),
+	m_direct(false),
+	m_directFileno(-1),
+	m_directIndex(0),
+	m_directFill(0),
+	m_directSynced(0),
+	m_directBase(-1) {
+
+	m_directData[0] = m_directData[1] = null;
+	m_directPending[0] = m_directPending[1] = false;
 }
 
 void BufferedRandomAccessFile::blockCompression(void) {
@@ -315,6 +367,9 @@ void BufferedRandomAccessFile::fill(boolean* eof, boolean validate) {
 	#endif
 
 	if (m_compressMode == COMPRESS_READ) {
+		// XXX: inflate needs a writable buffer
+		unmapBuffer();
+
 		nbyte sizeBuffer(SIZE_RESERVE);
 		RandomAccessFile::readFullyRaw(&sizeBuffer, 0, SIZE_RESERVE, eof);
 		if (*eof == true) {
@@ -419,7 +474,17 @@ void BufferedRandomAccessFile::fill(boolean* eof, boolean validate) {
 		delete m_zipBuffer;
 		m_zipBuffer = null;
 
+	} else if ((m_mapped == true) && (mapFill() == true)) {
+		return;
+
 	} else {
+		if (m_mapData != null) {
+			unmapBuffer();
+
+			// XXX: mapped reads do not move the handle
+			RandomAccessFile::seek(m_position, m_length);
+		}
+
 		inttype total = m_buffer.length;
 
 		m_offset = 0;
@@ -440,6 +505,339 @@ void BufferedRandomAccessFile::fill(boolean* eof, boolean validate) {
 	m_refill = false;
 }
 
+boolean BufferedRandomAccessFile::remap(void) {
+	if (getHandle() == null) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fileno(getHandle()), &st) != 0) {
+		return false;
+	}
+
+	longtype length = st.st_size;
+	if ((length <= m_mapLength) || (length > MAX_MAPPED_SIZE)) {
+		return false;
+	}
+
+	// XXX: file has grown within the reserved mapping (i.e. pages beyond the old length are now backed)
+	if (length <= m_mapSize) {
+		m_mapLength = length;
+		return true;
+	}
+
+	// XXX: reserve room to grow so that appends do not remap on every read
+	longtype size = (length + MAP_RESERVE) & ~(MAP_RESERVE - 1);
+	if (size > MAX_MAPPED_SIZE) {
+		size = MAX_MAPPED_SIZE;
+	}
+
+	voidarray data = mmap(null, size, PROT_READ, MAP_SHARED, fileno(getHandle()), 0);
+	if (data == MAP_FAILED) {
+		DEEP_LOG(WARN, OTHER, "Buffered random access file: mmap failed %d, falling back to buffered reads, %s\n", errno, getPath());
+
+		m_mapped = false;
+		return false;
+	}
+
+	unmap();
+
+	m_mapData = (bytearray) data;
+	m_mapLength = length;
+	m_mapSize = size;
+
+	setAccessMode(m_accessMode);
+
+	return true;
+}
+
+boolean BufferedRandomAccessFile::mapFill(void) {
+	if ((m_position >= m_mapLength) && ((remap() == false) || (m_position >= m_mapLength))) {
+		return false;
+	}
+
+	if (m_heapData == null) {
+		m_heapData = (bytearray) m_buffer;
+		m_heapLength = m_buffer.length;
+	}
+
+	// XXX: the whole mapping is the buffer, seeks within the file only move the cursor
+	m_buffer.reassign(m_mapData, (inttype) m_mapLength);
+	m_cursor = (inttype) m_position;
+	m_offset = (inttype) m_mapLength;
+	m_position = m_mapLength;
+	m_refill = false;
+
+	return true;
+}
+
+void BufferedRandomAccessFile::unmapBuffer(void) {
+	if (m_heapData != null) {
+		m_buffer.reassign(m_heapData, m_heapLength);
+
+		m_heapData = null;
+		m_heapLength = 0;
+	}
+}
+
+void BufferedRandomAccessFile::unmap(void) {
+	if (m_mapData != null) {
+		unmapBuffer();
+
+		munmap(m_mapData, m_mapSize);
+
+		m_mapData = null;
+		m_mapLength = 0;
+		m_mapSize = 0;
+	}
+}
+
+void BufferedRandomAccessFile::setAccessMode(AccessMode mode) {
+	m_accessMode = mode;
+
+	if (m_mapData != null) {
+		switch (mode) {
+			case ACCESS_SEQUENTIAL:
+				madvise(m_mapData, m_mapSize, MADV_SEQUENTIAL);
+				break;
+			case ACCESS_WILLNEED:
+				madvise(m_mapData, m_mapLength, MADV_WILLNEED);
+				break;
+			default:
+				madvise(m_mapData, m_mapSize, MADV_RANDOM);
+				break;
+		}
+	}
+}
+
+void BufferedRandomAccessFile::setDirectWrite(boolean direct) {
+	if ((direct == true) && (strcmp(m_mode, "rw") != 0)) {
+		DEEP_LOG(ERROR, OTHER, "Invalid direct write: file is not a writer, %s\n", getPath());
+
+		throw InvalidException("Invalid direct write: file is not a writer");
+	}
+
+	if (direct == m_direct) {
+		return;
+	}
+
+	if (direct == false) {
+		if (getHandle() != null) {
+			flush();
+		}
+
+		directClose();
+
+		m_direct = false;
+
+	} else {
+		m_direct = true;
+
+		// XXX: otherwise opened on attach
+		if (getHandle() != null) {
+			directOpen();
+		}
+	}
+}
+
+boolean BufferedRandomAccessFile::directOpen(void) {
+	m_directFileno = open(getPath(), O_WRONLY | O_DIRECT);
+	if (m_directFileno == -1) {
+		DEEP_LOG(WARN, OTHER, "Buffered random access file: O_DIRECT open failed %d, falling back to buffered writes, %s\n", errno, getPath());
+
+		m_direct = false;
+		return false;
+	}
+
+	for (inttype i = 0; i < 2; i++) {
+		voidarray data = null;
+		if (posix_memalign(&data, DIRECT_ALIGNMENT, DIRECT_BLOCK_SIZE) != 0) {
+			DEEP_LOG(WARN, OTHER, "Buffered random access file: aligned allocation failed, falling back to buffered writes, %s\n", getPath());
+
+			directClose();
+
+			m_direct = false;
+			return false;
+		}
+
+		m_directData[i] = (bytearray) data;
+		m_directPending[i] = false;
+	}
+
+	m_directIndex = 0;
+	m_directFill = 0;
+	m_directSynced = 0;
+	m_directBase = -1;
+
+	return true;
+}
+
+void BufferedRandomAccessFile::directClose(void) {
+	if (m_directFileno == -1) {
+		return;
+	}
+
+	if (getHandle() != null) {
+		directDrain();
+	}
+
+	for (inttype i = 0; i < 2; i++) {
+		// XXX: never release a buffer the kernel is still reading from
+		if (m_directPending[i] == true) {
+			const struct aiocb* list[1] = { &m_directControl[i] };
+			while (aio_error(&m_directControl[i]) == EINPROGRESS) {
+				aio_suspend(list, 1, null);
+			}
+
+			aio_return(&m_directControl[i]);
+			m_directPending[i] = false;
+		}
+
+		free(m_directData[i]);
+		m_directData[i] = null;
+	}
+
+	::close(m_directFileno);
+	m_directFileno = -1;
+	m_directBase = -1;
+}
+
+void BufferedRandomAccessFile::directEstablish(void) {
+	const longtype position = RandomAccessFile::getFilePointer();
+
+	m_directBase = position & ~((longtype) DIRECT_ALIGNMENT - 1);
+	m_directFill = (inttype) (position - m_directBase);
+	m_directSynced = m_directFill;
+
+	// XXX: the head of the first block is already on file, read it back so the whole block can be written aligned
+	if (m_directFill != 0) {
+		fflush(getHandle());
+
+		if (pread(fileno(getHandle()), m_directData[m_directIndex], m_directFill, m_directBase) != m_directFill) {
+			DEEP_LOG(ERROR, OTHER, "Invalid direct write: head read failure %d, %s\n", errno, getPath());
+
+			throw IOException("Invalid direct write: head read failure");
+		}
+	}
+}
+
+void BufferedRandomAccessFile::directWrite(const bytearray data, inttype length) {
+	if (m_directBase == -1) {
+		directEstablish();
+	}
+
+	inttype offset = 0;
+	while (offset < length) {
+		inttype count = DIRECT_BLOCK_SIZE - m_directFill;
+		if (count > (length - offset)) {
+			count = length - offset;
+		}
+
+		memcpy(m_directData[m_directIndex] + m_directFill, data + offset, count);
+
+		m_directFill += count;
+		offset += count;
+
+		if (m_directFill == DIRECT_BLOCK_SIZE) {
+			directSubmit();
+		}
+	}
+}
+
+void BufferedRandomAccessFile::directSubmit(void) {
+	const ubytetype next = (m_directIndex + 1) % 2;
+
+	// XXX: double buffered, only wait when the previous block is still in flight
+	directComplete(next);
+
+	struct aiocb* control = &m_directControl[m_directIndex];
+	memset(control, 0, sizeof(struct aiocb));
+	control->aio_fildes = m_directFileno;
+	control->aio_buf = m_directData[m_directIndex];
+	control->aio_nbytes = DIRECT_BLOCK_SIZE;
+	control->aio_offset = m_directBase;
+	control->aio_sigevent.sigev_notify = SIGEV_NONE;
+
+	if (aio_write(control) == 0) {
+		m_directPending[m_directIndex] = true;
+
+	} else {
+		// XXX: e.g. EAGAIN, write the block in place
+		if (pwrite(m_directFileno, m_directData[m_directIndex], DIRECT_BLOCK_SIZE, m_directBase) != DIRECT_BLOCK_SIZE) {
+			DEEP_LOG(ERROR, OTHER, "Invalid direct write: block write failure %d, %s\n", errno, getPath());
+
+			throw IOException("Invalid direct write: block write failure");
+		}
+
+		if (RandomAccessFile::length() < (m_directBase + DIRECT_BLOCK_SIZE)) {
+			RandomAccessFile::setLength(m_directBase + DIRECT_BLOCK_SIZE, false /* modify */);
+		}
+	}
+
+	m_directIndex = next;
+	m_directBase += DIRECT_BLOCK_SIZE;
+	m_directFill = 0;
+	m_directSynced = 0;
+}
+
+void BufferedRandomAccessFile::directComplete(ubytetype index) {
+	if (m_directPending[index] == false) {
+		return;
+	}
+
+	struct aiocb* control = &m_directControl[index];
+	const struct aiocb* list[1] = { control };
+
+	inttype error;
+	while ((error = aio_error(control)) == EINPROGRESS) {
+		aio_suspend(list, 1, null);
+	}
+
+	ssize_t count = aio_return(control);
+	m_directPending[index] = false;
+
+	if (count != (ssize_t) control->aio_nbytes) {
+		DEEP_LOG(ERROR, OTHER, "Invalid direct write: block write failure %d, %s\n", error, getPath());
+
+		throw IOException("Invalid direct write: block write failure");
+	}
+
+	// XXX: readers are limited to the writer length, only expose the block once it is on file
+	if (RandomAccessFile::length() < (longtype) (control->aio_offset + control->aio_nbytes)) {
+		RandomAccessFile::setLength(control->aio_offset + control->aio_nbytes, false /* modify */);
+	}
+}
+
+void BufferedRandomAccessFile::directSync(void) {
+	directComplete((m_directIndex + 1) % 2);
+
+	// XXX: the partial tail goes through the page cache, the block is rewritten direct once it fills
+	if ((m_directBase != -1) && (m_directFill > m_directSynced)) {
+		getFD()->write(m_directData[m_directIndex] + m_directSynced, m_directFill - m_directSynced, m_directBase + m_directSynced);
+
+		m_directSynced = m_directFill;
+
+		if (RandomAccessFile::length() < (m_directBase + m_directFill)) {
+			RandomAccessFile::setLength(m_directBase + m_directFill, false /* modify */);
+		}
+	}
+}
+
+void BufferedRandomAccessFile::directDrain(void) {
+	if (m_directBase == -1) {
+		return;
+	}
+
+	directSync();
+
+	// XXX: the stdio pointer is not moved by direct writes
+	RandomAccessFile::seek(m_directBase + m_directFill);
+
+	m_directBase = -1;
+	m_directFill = 0;
+	m_directSynced = 0;
+}
+
 void BufferedRandomAccessFile::attach(void) {
 	RandomAccessFile::attach();
 
@@ -474,10 +872,18 @@ void BufferedRandomAccessFile::attach(void) {
 		m_position = length();
 
 		RandomAccessFile::seek(m_position);
+
+		if (m_direct == true) {
+			directOpen();
+		}
 	}
 }
 
 void BufferedRandomAccessFile::detach(void) {
+	unmap();
+
+	directClose();
+
 	RandomAccessFile::detach();
 
 	m_buffer.realloc(0);
@@ -489,6 +895,10 @@ void BufferedRandomAccessFile::close() {
 			flush();
 		}
 
+		unmap();
+
+		directClose();
+
 		RandomAccessFile::close();
 
 		m_buffer.realloc(0);
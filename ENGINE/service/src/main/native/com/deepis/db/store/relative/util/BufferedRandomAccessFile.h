@@ -28,7 +28,9 @@
 #ifndef COM_DEEPIS_DB_STORE_RELATIVE_UTIL_BUFFEREDRANDOMACCESSFILE_H_
 #define COM_DEEPIS_DB_STORE_RELATIVE_UTIL_BUFFEREDRANDOMACCESSFILE_H_ 
 
+#include <aio.h>
 #include <zlib.h>
+#include <sys/mman.h>
 
 #include "cxx/util/Logger.h"
 #include "cxx/io/IOException.h"
@@ -51,6 +53,12 @@ class BufferedRandomAccessFile : public RandomAccessFile {
 			COMPRESS_READ
 		};
 
+		enum AccessMode {
+			ACCESS_RANDOM,
+			ACCESS_SEQUENTIAL,
+			ACCESS_WILLNEED
+		};
+
 	private:
 
 		enum FinalizeMode {
@@ -61,6 +69,10 @@ class BufferedRandomAccessFile : public RandomAccessFile {
 
 		static const ubytetype SIZE_RESERVE = (2 * sizeof(uinttype));
 		static const uinttype MAX_UNCOMPRESSED_SIZE = /* 100M */ 104857600;  
+		static const longtype MAX_MAPPED_SIZE = /* 2G (i.e. cursor/offset limit) */ 0x7fffffff;
+		static const longtype MAP_RESERVE = /* 64M */ 67108864;
+		static const inttype DIRECT_ALIGNMENT = /* 4K */ 4096;
+		static const inttype DIRECT_BLOCK_SIZE = /* 1M */ 1048576;
 
 		nbyte m_buffer;
 		nbyte* m_zipBuffer;
@@ -88,7 +100,42 @@ class BufferedRandomAccessFile : public RandomAccessFile {
 
 		boolean m_refill;
 
+		// XXX: read-only memory mapping, m_buffer becomes a view on the entire mapping (see mapFill)
+		boolean m_mapped;
+		AccessMode m_accessMode;
+		bytearray m_mapData;
+		longtype m_mapLength;
+		longtype m_mapSize;
+		bytearray m_heapData;
+		inttype m_heapLength;
+
+		// XXX: O_DIRECT streaming writer, appends are staged in aligned blocks and full blocks are written behind (see directWrite)
+		boolean m_direct;
+		inttype m_directFileno;
+		ubytetype m_directIndex;
+		inttype m_directFill;
+		inttype m_directSynced;
+		longtype m_directBase;
+		bytearray m_directData[2];
+		boolean m_directPending[2];
+		struct aiocb m_directControl[2];
+
 	private:
+		boolean remap(void);
+		boolean mapFill(void);
+		void unmapBuffer(void);
+		void unmap(void);
+
+		boolean directOpen(void);
+		void directClose(void);
+		void directEstablish(void);
+		void directWrite(const bytearray data, inttype length);
+		void directSubmit(void);
+		void directComplete(ubytetype index);
+		void directSync(void);
+		void directDrain(void);
+
+		FORCE_INLINE void spill(void);
 
 		uinttype compressToBuffer(const nbyte* bytes, int offset, int length, FinalizeMode finalizeMode);
 		uinttype compressToBuffer(bytetype b);
@@ -177,6 +224,32 @@ class BufferedRandomAccessFile : public RandomAccessFile {
 			return m_compressMode;
 		}
 
+		// XXX: only legal for "r" files, reads past the mapping (e.g. unsynced writer) fall back to buffered fills
+		FORCE_INLINE void setMemoryMapped(boolean mapped) {
+			m_mapped = mapped;
+		}
+
+		FORCE_INLINE boolean getMemoryMapped() const {
+			return m_mapped;
+		}
+
+		FORCE_INLINE boolean isMapped() const {
+			return (m_mapData != null);
+		}
+
+		void setAccessMode(AccessMode mode);
+
+		FORCE_INLINE AccessMode getAccessMode() const {
+			return m_accessMode;
+		}
+
+		// XXX: only legal for "rw" (i.e. streaming) files, full blocks bypass the page cache and the tail is written at flush
+		void setDirectWrite(boolean direct);
+
+		FORCE_INLINE boolean getDirectWrite() const {
+			return m_direct;
+		}
+
 		FORCE_INLINE longtype getAndResetBlockLength() {
 			longtype length = m_blockLength;
 			m_blockLength = -1;
@@ -229,6 +302,10 @@ class BufferedRandomAccessFile : public RandomAccessFile {
 		virtual ~BufferedRandomAccessFile() {
 			//XXX: could be allocated in case of exceptions thrown from fill method
 			delete m_zipBuffer; 
+
+			unmap();
+
+			directClose();
 		}
 
 		FORCE_INLINE void flush();
@@ -266,7 +343,12 @@ FORCE_INLINE void BufferedRandomAccessFile::flush() {
 
 	if (m_cursor != 0) {
 
-		RandomAccessFile::write(&m_buffer, 0, m_cursor);
+		if (m_direct == true) {
+			directWrite(m_buffer, m_cursor);
+
+		} else {
+			RandomAccessFile::write(&m_buffer, 0, m_cursor);
+		}
 
 		if (m_notify == true) {
 			m_flushed = true;
@@ -274,6 +356,22 @@ FORCE_INLINE void BufferedRandomAccessFile::flush() {
 
 		m_cursor = 0;
 	}
+
+	// XXX: staged blocks (see spill) become visible to readers at flush
+	if (m_direct == true) {
+		directSync();
+	}
+}
+
+FORCE_INLINE void BufferedRandomAccessFile::spill() {
+	// XXX: buffer is full (i.e. not a flush point), direct writes only stage the buffer and are made visible at flush
+	if (m_direct == true) {
+		directWrite(m_buffer, m_cursor);
+		m_cursor = 0;
+
+	} else {
+		flush();
+	}
 }
 
 FORCE_INLINE int BufferedRandomAccessFile::read(boolean* eof) {
@@ -405,7 +503,7 @@ FORCE_INLINE void BufferedRandomAccessFile::write(int b) {
 
 	} else {
 		if (m_cursor >= m_buffer.length) {
-			flush();
+			spill();
 		}
 
 		m_buffer[m_cursor] = (bytetype) b;
@@ -430,11 +528,17 @@ FORCE_INLINE void BufferedRandomAccessFile::write(const nbyte* bytes, int offset
 
 		if ((m_cursor + length) >= m_buffer.length) {
 
-			flush();
+			spill();
 
 			// XXX: handle changes greater than internal buffer
 			if (length >= m_buffer.length) {
-				RandomAccessFile::write(bytes, offset, length);
+				if (m_direct == true) {
+					directWrite((*bytes) + offset, length);
+
+				} else {
+					RandomAccessFile::write(bytes, offset, length);
+				}
+
 				m_position += length;
 				return;
 			}
@@ -460,7 +564,14 @@ FORCE_INLINE void BufferedRandomAccessFile::writeRaw(const nbyte* bytes, int off
 
 	flush();
 
-	RandomAccessFile::write(bytes, offset, length);
+	if (m_direct == true) {
+		directWrite((*bytes) + offset, length);
+		directSync();
+
+	} else {
+		RandomAccessFile::write(bytes, offset, length);
+	}
+
 	m_position += length;
 }
 
@@ -570,6 +681,10 @@ FORCE_INLINE void BufferedRandomAccessFile::seek(longtype pos, boolean validate)
 			if (BufferedRandomAccessFile::getFilePointer() != pos) {
 				flush();
 
+				if (m_direct == true) {
+					directDrain();
+				}
+
 				RandomAccessFile::seek(pos);
 				m_position = pos;
 			}
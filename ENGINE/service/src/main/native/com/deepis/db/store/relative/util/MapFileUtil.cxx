@@ -47,6 +47,7 @@ const String MapFileUtil::FILE_SUFFIX_VRT = ".vrt";
 const String MapFileUtil::FILE_SUFFIX_TRT = ".trt";
 const String MapFileUtil::FILE_SUFFIX_SRT = ".srt";
 const String MapFileUtil::FILE_SUFFIX_XRT = ".xrt";
+const String MapFileUtil::FILE_SUFFIX_HRT = ".hrt";
 
 static boolean hasZeroSuffix(RandomAccessFile& rfile) {
 	nbyte buf(102400);
@@ -93,6 +94,7 @@ boolean MapFileUtil::move(const String& source, const String& target) {
 		const String vrtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_VRT;
 		const String srtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_SRT;
 		const String xrtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_XRT;
+		const String hrtName = sourceName + MapFileUtil::FILE_SUFFIX_HRT;
 		
 		for (int i = 0; i < list->size(); i++) {
 			String* item = list->get(i);
@@ -101,7 +103,8 @@ boolean MapFileUtil::move(const String& source, const String& target) {
 				item->endsWith(lrtSuffix) == false &&
 				item->endsWith(vrtSuffix) == false &&
 				item->endsWith(srtSuffix) == false &&
-				item->endsWith(xrtSuffix) == false) {
+				item->endsWith(xrtSuffix) == false &&
+				(*item != hrtName)) {
 				continue;
 			}
 
@@ -177,6 +180,7 @@ boolean MapFileUtil::clobber(const String& fileName, const boolean values, uintt
 		const String vrtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_VRT;
 		const String srtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_SRT;
 		const String xrtSuffix = MapFileUtil::FILE_INFIX + sourceName + MapFileUtil::FILE_SUFFIX_XRT;
+		const String hrtName = sourceName + MapFileUtil::FILE_SUFFIX_HRT;
 		
 		uinttype othersCount = 0;
 		for (int i = 0; i < list->size(); i++) {
@@ -187,7 +191,8 @@ boolean MapFileUtil::clobber(const String& fileName, const boolean values, uintt
 					(item->endsWith(lrtSuffix) == true ||
 					 item->endsWith(vrtSuffix) == true ||
 					 item->endsWith(srtSuffix) == true ||
-					 item->endsWith(xrtSuffix) == true))) == false) {
+					 item->endsWith(xrtSuffix) == true ||
+					 (*item == hrtName)))) == false) {
 				othersCount++;
 				continue;
 			}
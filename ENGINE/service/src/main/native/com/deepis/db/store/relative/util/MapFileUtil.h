@@ -46,6 +46,7 @@ class MapFileUtil {
 		static const String FILE_SUFFIX_TRT;
 		static const String FILE_SUFFIX_SRT;
 		static const String FILE_SUFFIX_XRT;
+		static const String FILE_SUFFIX_HRT;
 
 		enum FileType {
 			IRT,
@@ -40,6 +40,7 @@
 #include "cxx/util/concurrent/atomic/AtomicLong.h"
 
 #include "com/deepis/db/store/relative/core/Properties.h"
+#include "com/deepis/db/store/relative/core/RealTimeMetrics.h"
 #include "com/deepis/db/store/relative/util/MapFileSet.h"
 #include "com/deepis/db/store/relative/util/MapFileUtil.h"
 #include "com/deepis/db/store/relative/util/BufferedRandomAccessFile.h"
@@ -53,11 +54,70 @@ namespace com { namespace deepis { namespace db { namespace store { namespace re
 
 class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 
+	public:
+		// XXX: completed by the sync leader once every file prepared ahead of it is on disk (see requestSynchronizeGlobally)
+		class Ticket : public Synchronizable {
+			private:
+				Ticket* m_next;
+				volatile boolean m_complete;
+
+			friend class MeasuredRandomAccessFile;
+
+			protected:
+				// XXX: override to be called back, invoked from the sync leader outside of any sync lock
+				virtual void completed(void) {
+				}
+
+			public:
+				Ticket(void):
+					m_next(null),
+					m_complete(false) {
+				}
+
+				virtual ~Ticket(void) {
+				}
+
+				FORCE_INLINE boolean isComplete(void) const {
+					return m_complete;
+				}
+
+				FORCE_INLINE void await(void) {
+					synchronized(this) {
+						while (m_complete == false) {
+							wait();
+						}
+					}
+				}
+
+				FORCE_INLINE void complete(void) {
+					m_next = null;
+
+					completed();
+
+					synchronized(this) {
+						m_complete = true;
+						notifyAll();
+					}
+				}
+		};
+
 	private:
 		static AtomicLong s_syncCount;
 		static Synchronizable s_syncEvent;
 		static BasicArray<MeasuredRandomAccessFile*> s_syncFiles;
 
+		static Ticket* volatile s_syncTickets;
+		static Synchronizable s_syncRequest;
+
+		FORCE_INLINE static void completeSynchronizeGlobally(Ticket* tickets) {
+			while (tickets != null) {
+				// XXX: a completed ticket may be released by its owner
+				Ticket* next = tickets->m_next;
+				tickets->complete();
+				tickets = next;
+			}
+		}
+
 	public:
 		FORCE_INLINE static void planSynchronizeGlobally(void) {
 			s_syncCount.incrementAndGet();
@@ -97,8 +157,14 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 				start = System::currentTimeMillis();
 			}
 
+			Ticket* tickets = null;
+
 			synchronized(s_syncEvent) {
 				if ((decrement == false) || (s_syncCount.decrementAndGet() == 0)) {
+					// XXX: tickets were queued after their files were prepared, hence covered by this round
+					tickets = s_syncTickets;
+					s_syncTickets = null;
+
 					for (inttype i = 0; i < s_syncFiles.size(); i++) {
 						MeasuredRandomAccessFile* file = s_syncFiles.get(i);
 						if (file == null) {
@@ -119,6 +185,8 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 				}
 			}
 
+			completeSynchronizeGlobally(tickets);
+
 			longtype stop = 0;
 			if (holddown == true) {
 				stop = System::currentTimeMillis();
@@ -127,6 +195,30 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 			return stop-start;
 		}
 
+		// XXX: queue a ticket instead of waiting, the next sync round (leader or sync thread) completes it
+		FORCE_INLINE static void requestSynchronizeGlobally(Ticket* ticket) {
+			ticket->m_complete = false;
+
+			synchronized(s_syncEvent) {
+				ticket->m_next = s_syncTickets;
+				s_syncTickets = ticket;
+			}
+
+			synchronized(s_syncRequest) {
+				s_syncRequest.notifyAll();
+			}
+		}
+
+		FORCE_INLINE static boolean awaitSynchronizeGlobally(longtype timeout) {
+			synchronized(s_syncRequest) {
+				if (s_syncTickets == null) {
+					s_syncRequest.wait(timeout);
+				}
+			}
+
+			return (s_syncTickets != null);
+		}
+
 		FORCE_INLINE static void syncAndCloseFiles(MeasuredRandomAccessFile* vwfile, MeasuredRandomAccessFile* lwfile) {
 			synchronized(s_syncEvent) {
 				vwfile->syncPerform(false);
@@ -167,6 +259,9 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 		bytetype m_indexValue;
 		longtype m_awaitingDeletionLength;
 
+		// XXX: plain counter on the write path (i.e. approximate when a sync races the writer), published to RealTimeMetrics at sync and close
+		ulongtype m_bytesWritten;
+
 		boolean m_closureFile:1;
 		boolean m_reorgComplete:1;
 
@@ -181,6 +276,9 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 			// XXX: m_syncable to false in fdsync
 			fdsync();
 
+			RealTimeMetrics::FILE_SYNCS.add();
+			publishWritten();
+
 			// XXX: not actively being used
 			if ((deactivate == true) && (tryLock() == true)) {
 				setActive(false);
@@ -189,6 +287,13 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 			}
 		}
 
+		FORCE_INLINE void publishWritten(void) {
+			if (m_bytesWritten != 0) {
+				RealTimeMetrics::FILE_BYTES_WRITTEN.add(m_bytesWritten);
+				m_bytesWritten = 0;
+			}
+		}
+
 		FORCE_INLINE boolean syncPrepared(void) {
 			return m_syncable;
 		}
@@ -230,6 +335,7 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 			m_recoveryEpoch(0),
 			m_indexValue(0),
 			m_awaitingDeletionLength(0),
+			m_bytesWritten(0),
 			m_closureFile(false),
 			m_reorgComplete(false),
 			m_awaitingDeletion(false),
@@ -267,6 +373,7 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 			m_recoveryEpoch(0),
 			m_indexValue(0),
 			m_awaitingDeletionLength(0),
+			m_bytesWritten(0),
 			m_closureFile(false),
 			m_reorgComplete(false),
 			m_awaitingDeletion(false),
@@ -294,6 +401,8 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 					}
 				}
 			}
+
+			publishWritten();
 		}
 
 		FORCE_INLINE MapFileUtil::FileType getType() const {
@@ -458,6 +567,7 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 		FORCE_INLINE virtual void write(int b) {
 			CXX_LANG_MEMORY_DEBUG_ASSERT(this);
 			BufferedRandomAccessFile::write(b);
+			m_bytesWritten++;
 		}
 
 		FORCE_INLINE virtual void write(const nbyte* bytes) {
@@ -468,11 +578,13 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 		FORCE_INLINE virtual void write(const nbyte* bytes, int offset, int length) {
 			CXX_LANG_MEMORY_DEBUG_ASSERT(this);
 			BufferedRandomAccessFile::write(bytes, offset, length);
+			m_bytesWritten += length;
 		}
 
 		FORCE_INLINE void writeRaw(const nbyte* bytes, int offset, int length) {
 			CXX_LANG_MEMORY_DEBUG_ASSERT(this);
 			BufferedRandomAccessFile::write(bytes, offset, length);
+			m_bytesWritten += length;
 		}
 
 		FORCE_INLINE void setPercentFragmented(doubletype value) {
@@ -581,6 +693,8 @@ class MeasuredRandomAccessFile : public BufferedRandomAccessFile {
 AtomicLong MeasuredRandomAccessFile::s_syncCount(0);
 Synchronizable MeasuredRandomAccessFile::s_syncEvent;
 BasicArray<MeasuredRandomAccessFile*> MeasuredRandomAccessFile::s_syncFiles(Properties::DEFAULT_FILE_ARRAY, false);
+MeasuredRandomAccessFile::Ticket* volatile MeasuredRandomAccessFile::s_syncTickets = null;
+Synchronizable MeasuredRandomAccessFile::s_syncRequest;
 
 } } } } } } // namespace
 
@@ -30,6 +30,9 @@ void testPut();
 void testContains();
 void testGet();
 void testWalk();
+void testLatency(boolean written);
+void testTrace();
+void testMetrics();
 
 int main(int argc, char** argv) {
 
@@ -43,6 +46,8 @@ int main(int argc, char** argv) {
 	bDynamic = options.getInteger("-d", bDynamic);
 
 	Properties::setDynamicResources(bDynamic);
+	Properties::setLatencyStatistics(true);
+	Properties::setMetricsPath("./datastore.metrics");
 
 	startup(true);
 
@@ -50,6 +55,7 @@ int main(int argc, char** argv) {
 	testContains();
 	testGet();
 	testWalk();
+	testLatency(true);
 
 	shutdown();
 	startup(false);
@@ -57,9 +63,13 @@ int main(int argc, char** argv) {
 	testContains();
 	testGet();
 	testWalk();
+	testLatency(false);
+	testMetrics();
 
 	shutdown();
 
+	testTrace();
+
 	return 0;
 }
 
@@ -257,3 +267,90 @@ void testWalk() {
 
 	delete iter;
 }
+
+void testLatency(boolean written) {
+
+	const RealTimeLatency* latency = MAP->getLatency();
+	if (latency == null) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Latency statistics not enabled\n");
+		exit(-1);
+	}
+
+	for (int o = 0; o < RealTimeLatency::OPERATIONS; o++) {
+		const RealTimeLatency::Operation operation = (RealTimeLatency::Operation) o;
+
+		const ulongtype count = latency->getCount(operation);
+		if (count == 0) {
+			continue;
+		}
+
+		const ulongtype p50 = latency->getPercentile(operation, 0.50);
+		const ulongtype p99 = latency->getPercentile(operation, 0.99);
+		const ulongtype p999 = latency->getPercentile(operation, 0.999);
+
+		DEEP_LOG(INFO, OTHER, " LATENCY %s: %llu, p50/p99/p999: %llu/%llu/%llu ns\n", RealTimeLatency::getName(operation), count, p50, p99, p999);
+
+		if ((p50 > p99) || (p99 > p999)) {
+			DEEP_LOG(ERROR, OTHER, "FAILED - Latency percentiles out of order: %s\n", RealTimeLatency::getName(operation));
+			exit(-1);
+		}
+	}
+
+	// XXX: contains and get both time as exact gets
+	if (latency->getCount(RealTimeLatency::GET) < (2 * (ulongtype) COUNT)) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Latency get count: %llu\n", latency->getCount(RealTimeLatency::GET));
+		exit(-1);
+	}
+
+	if ((written == true) && ((latency->getCount(RealTimeLatency::PUT) != (ulongtype) COUNT) || (latency->getCount(RealTimeLatency::COMMIT) == 0))) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Latency put/commit count: %llu/%llu\n", latency->getCount(RealTimeLatency::PUT), latency->getCount(RealTimeLatency::COMMIT));
+		exit(-1);
+	}
+}
+
+void testTrace() {
+
+	// XXX: unmount always records a finalize span, index and purge spans depend on resource thread timing
+	const longtype spans = RealTimeTrace::dump("./datastore.trace.json");
+	if (spans <= 0) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Trace dump: %lld\n", spans);
+		exit(-1);
+	}
+
+	DEEP_LOG(INFO, OTHER, " TRACE SPANS: %lld\n", spans);
+}
+
+void testMetrics() {
+
+	RealTimeMetrics metrics;
+	((RealTime*) MAP)->metricStatistics(&metrics);
+
+	if (metrics.write("./datastore.metrics.test") == false) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Metrics write\n");
+		exit(-1);
+	}
+
+	FILE* file = fopen("./datastore.metrics.test", "r");
+	if (file == null) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Metrics open\n");
+		exit(-1);
+	}
+
+	char buffer[8192];
+	const size_t length = fread(buffer, 1, sizeof(buffer) - 1, file);
+	buffer[length] = '\0';
+	fclose(file);
+
+	char entries[256];
+	snprintf(entries, sizeof(entries), "deep_map_entries{map=\"%s\"} %d\n", MAP->getFilePath(), COUNT);
+
+	const char* expected[] = { "# TYPE deep_map_entries gauge\n", entries, "# TYPE deep_segments_purged_total counter\n", "# TYPE deep_file_bytes_written_total counter\n" };
+	for (uinttype i = 0; i < (sizeof(expected) / sizeof(expected[0])); i++) {
+		if (strstr(buffer, expected[i]) == null) {
+			DEEP_LOG(ERROR, OTHER, "FAILED - Metrics missing: %s", expected[i]);
+			exit(-1);
+		}
+	}
+
+	DEEP_LOG(INFO, OTHER, " METRICS: %llu bytes\n", (ulongtype) length);
+}
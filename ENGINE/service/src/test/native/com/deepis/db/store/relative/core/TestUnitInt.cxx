@@ -31,6 +31,7 @@ void testPut();
 void testContains(int start, int end, boolean exists);
 void testGet(int start, int end);
 void testUpdate();
+void testCommitAsync();
 void testRemove(int start, int end);
 
 int main(int argc, char** argv) {
@@ -48,6 +49,7 @@ int main(int argc, char** argv) {
 	testContains(0, COUNT, true);
 	testGet(0, COUNT);
 	testUpdate();
+	testCommitAsync();
 
 #if RESTART
 	DEEP_LOG(INFO, OTHER, "  Wait 15 seconds to complete irt write out before continuing\n");
@@ -298,6 +300,71 @@ void testUpdate() {
 	DEEP_LOG(INFO, OTHER, "  UPDATE TIME: %d, %lld\n", COUNT, (gstop-gstart));
 }
 
+class CountingTicket : public MeasuredRandomAccessFile::Ticket {
+	public:
+		volatile inttype m_count;
+
+		CountingTicket(void):
+			m_count(0) {
+		}
+
+	protected:
+		virtual void completed(void) {
+			__sync_add_and_fetch(&m_count, 1);
+		}
+};
+
+void testCommitAsync() {
+
+	static const int TICKETS = 10;
+
+	Transaction* tx = Transaction::create(true);
+
+	longtype gstart = System::currentTimeMillis();
+
+	for (int durable = 1; durable >= 0; durable--) {
+		Properties::setDurable(durable == 1);
+
+		CountingTicket tickets[TICKETS];
+		for (int i = 0; i < TICKETS; i++) {
+			tx->begin();
+			MAP->associate(tx);
+
+			for (int key = i; key < COUNT; key += TICKETS) {
+				if (MAP->put(key, &DATA, RealTimeMap<int>::EXISTING, tx) == false) {
+					DEEP_LOG(ERROR, OTHER, "FAILED - Update %d, %d\n", key, MAP->getErrorCode());
+					exit(-1);
+				}
+			}
+
+			tx->commitAsync(tx->getLevel(), &tickets[i]);
+
+			// XXX: non-durable commits have nothing to wait for
+			if ((durable == 0) && (tickets[i].isComplete() == false)) {
+				DEEP_LOG(ERROR, OTHER, "FAILED - Commit async %d not complete\n", i);
+				exit(-1);
+			}
+		}
+
+		for (int i = 0; i < TICKETS; i++) {
+			tickets[i].await();
+
+			if (tickets[i].m_count != 1) {
+				DEEP_LOG(ERROR, OTHER, "FAILED - Commit async %d completed %d times\n", i, tickets[i].m_count);
+				exit(-1);
+			}
+		}
+	}
+
+	Properties::setDurable(true);
+
+	Transaction::destroy(tx);
+
+	longtype gstop = System::currentTimeMillis();
+
+	DEEP_LOG(INFO, OTHER, "  COMMIT ASYNC TIME: %d, %lld\n", COUNT, (gstop-gstart));
+}
+
 void testRemove(int start, int end) {
 
 	int commit = 0;
@@ -35,6 +35,8 @@ void testContains();
 void testGet();
 void testUpdate();
 void testRemove();
+void testWriteBatch();
+void testMount();
 
 int main(int argc, char** argv) {
 
@@ -51,10 +53,22 @@ int main(int argc, char** argv) {
 	testGet();
 	testUpdate();
 	testGet();
+
+	// XXX: secondary keys are unchanged by testUpdate, i.e. changes may be buffered in unfilled segments
+	Properties::setSecondaryDeferral(true);
+	testUpdate();
+	testGet();
+	Properties::setSecondaryDeferral(false);
+
+	DEEP_LOG(INFO, OTHER, " SECONDARY DEFERRED: %llu\n", RealTimeMetrics::SECONDARY_DEFERRED.get());
+
 	testRemove();
+	testWriteBatch();
 
 	shutdown();
 
+	testMount();
+
 	return 0;
 }
 
@@ -327,3 +341,238 @@ void testRemove() {
 	DEEP_LOG(INFO, OTHER, " REMOVE TIME: %lld\n", (gstop-gstart));
 	fflush(stdout);
 }
+
+static Transaction* batchReader() {
+
+	Transaction* tx = Transaction::create(true);
+	tx->begin();
+	MAP_PRIMARY->associate(tx);
+
+	return tx;
+}
+
+static boolean batchGet(int key, int secondary, boolean exists, Transaction* tx) {
+
+	int retkey = 0;
+
+	if (MAP_PRIMARY->get(key, &DATA, RealTimeMap<int>::EXACT, &retkey, tx) != exists) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Batch get %d, expected %d\n", key, exists);
+		return false;
+	}
+
+	if (MAP_SECONDARY->get(secondary, &DATA, RealTimeMap<int>::EXACT, &retkey, tx) != exists) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Batch secondary get %d, expected %d\n", secondary, exists);
+		return false;
+	}
+
+	return true;
+}
+
+void testWriteBatch() {
+
+	static const int BATCH = 10000;
+
+	Transaction* tx = Transaction::create(true);
+
+	longtype gstart = System::currentTimeMillis();
+
+	RealTimeWriteBatch<int> batch(MAP_PRIMARY, BATCH);
+
+	// XXX: insertion order is reversed, the batch applies in key order
+	for (int i = BATCH - 1; i >= 0; i--) {
+		int secondary = i * 10;
+		memcpy((bytearray) DATA, &secondary, sizeof(int));
+
+		batch.put(i, &DATA, RealTimeMap<int>::UNIQUE);
+	}
+
+	tx->begin();
+	MAP_PRIMARY->associate(tx);
+
+	if (MAP_PRIMARY->write(&batch, tx) == false) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Batch create %d, %d\n", batch.getFailed(), MAP_PRIMARY->getErrorCode());
+		exit(-1);
+	}
+
+	tx->commit(tx->getLevel());
+
+	Transaction* rtx = batchReader();
+	for (int i = 0; i < BATCH; i++) {
+		if (batchGet(i, i * 10, true, rtx) == false) {
+			exit(-1);
+		}
+	}
+	Transaction::destroy(rtx);
+
+	// XXX: one duplicate fails the whole batch
+	batch.clear();
+	for (int i = 0; i < 100; i++) {
+		int key = (i == 50) ? 5 : BATCH + i;
+
+		int secondary = key * 10;
+		memcpy((bytearray) DATA, &secondary, sizeof(int));
+
+		batch.put(key, &DATA, RealTimeMap<int>::UNIQUE);
+	}
+
+	tx->begin();
+	MAP_PRIMARY->associate(tx);
+
+	if ((MAP_PRIMARY->write(&batch, tx) == true) || (batch.getFailed() != 50)) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Batch duplicate %d\n", batch.getFailed());
+		exit(-1);
+	}
+
+	tx->commit(tx->getLevel());
+
+	rtx = batchReader();
+	for (int i = 0; i < 100; i++) {
+		if ((i != 50) && (batchGet(BATCH + i, (BATCH + i) * 10, false, rtx) == false)) {
+			exit(-1);
+		}
+	}
+	Transaction::destroy(rtx);
+
+	// XXX: removes and updates mixed, operations on one key apply in insertion order
+	batch.clear();
+	for (int i = 0; i < BATCH; i++) {
+		if ((i % 2) == 0) {
+			batch.remove(i);
+
+		} else {
+			int secondary = (i * 10) + 5;
+			memcpy((bytearray) DATA, &secondary, sizeof(int));
+
+			batch.put(i, &DATA, RealTimeMap<int>::EXISTING);
+		}
+	}
+
+	int secondary = BATCH * 10;
+	memcpy((bytearray) DATA, &secondary, sizeof(int));
+
+	batch.put(BATCH, &DATA);
+	batch.remove(BATCH);
+
+	tx->begin();
+	MAP_PRIMARY->associate(tx);
+
+	if (MAP_PRIMARY->write(&batch, tx) == false) {
+		DEEP_LOG(ERROR, OTHER, "FAILED - Batch update %d, %d\n", batch.getFailed(), MAP_PRIMARY->getErrorCode());
+		exit(-1);
+	}
+
+	tx->commit(tx->getLevel());
+
+	rtx = batchReader();
+	for (int i = 0; i < BATCH; i++) {
+		if ((i % 2) == 0) {
+			if (batchGet(i, i * 10, false, rtx) == false) {
+				exit(-1);
+			}
+
+		} else if ((batchGet(i, (i * 10) + 5, true, rtx) == false) || (batchGet(-1, i * 10, false, rtx) == false)) {
+			exit(-1);
+		}
+	}
+
+	if (batchGet(BATCH, BATCH * 10, false, rtx) == false) {
+		exit(-1);
+	}
+	Transaction::destroy(rtx);
+
+	Transaction::destroy(tx);
+
+	longtype gstop = System::currentTimeMillis();
+
+	DEEP_LOG(INFO, OTHER, " WRITE BATCH TIME: %lld\n", (gstop-gstart));
+	fflush(stdout);
+}
+
+void testMount() {
+
+	static const int TABLES = 8;
+	static const int ENTRIES = 10000;
+
+	Comparator<int> comparator;
+	KeyBuilder<int> keyBuilder;
+	keyBuilder.setOffset(0);
+
+	// XXX: first pass creates the tables, second pass rediscovers them from the shared directory listing
+	for (int pass = 0; pass < 2; pass++) {
+		longtype options = RealTimeMap<int>::O_CREATE | RealTimeMap<int>::O_SINGULAR | RealTimeMap<int>::O_FIXEDKEY | RealTimeMap<int>::O_KEYCOMPRESS;
+		if (pass == 0) {
+			options |= RealTimeMap<int>::O_DELETE;
+		}
+
+		// XXX: the secondary is listed ahead of its primary, the batch must still mount it after
+		RealTimeMap<int>* maps[TABLES + 1];
+		maps[0] = new RealTimeMap<int>("./mount.secondary.datastore", options, sizeof(int), DATA_SIZE, &comparator, &keyBuilder);
+
+		for (int t = 0; t < TABLES; t++) {
+			char name[64];
+			snprintf(name, sizeof(name), "./mount.%d.datastore", t);
+
+			maps[t + 1] = new RealTimeMap<int>(name, options, sizeof(int), DATA_SIZE);
+		}
+
+		maps[1]->associate(maps[0], true);
+
+		longtype start = System::currentTimeMillis();
+
+		if (RealTimeMap<int>::mount(maps, TABLES + 1, 4) == false) {
+			DEEP_LOG(ERROR, OTHER, "FAILED - Concurrent mount, pass %d\n", pass);
+			exit(-1);
+		}
+
+		for (int t = 1; t <= TABLES; t++) {
+			maps[t]->recover(false);
+		}
+
+		DEEP_LOG(INFO, OTHER, " CONCURRENT MOUNT TIME: %d, %lld\n", TABLES + 1, System::currentTimeMillis() - start);
+
+		for (int t = 1; t <= TABLES; t++) {
+			Transaction* tx = Transaction::create(true);
+			tx->begin();
+			maps[t]->associate(tx);
+
+			for (int i = 0; i < ENTRIES; i++) {
+				int key = i * 10;
+
+				bytearray data = DATA;
+				memcpy(data, &key, sizeof(int));
+
+				if (pass == 0) {
+					if (maps[t]->put(i, &DATA, RealTimeMap<int>::UNIQUE, tx) == false) {
+						DEEP_LOG(ERROR, OTHER, "FAILED - Mount create %d, %d\n", t, i);
+						exit(-1);
+					}
+
+				} else if (maps[t]->contains(i, RealTimeMap<int>::EXACT, null, tx) == false) {
+					DEEP_LOG(ERROR, OTHER, "FAILED - Mount contains %d, %d\n", t, i);
+					exit(-1);
+				}
+
+				if ((pass == 1) && (t == 1) && (maps[0]->contains(key, RealTimeMap<int>::EXACT, null, tx) == false)) {
+					DEEP_LOG(ERROR, OTHER, "FAILED - Mount secondary contains %d\n", key);
+					exit(-1);
+				}
+			}
+
+			if (pass == 0) {
+				tx->commit(tx->getLevel());
+			}
+
+			Transaction::destroy(tx);
+		}
+
+		for (int t = 1; t <= TABLES; t++) {
+			maps[t]->unmount(false);
+		}
+
+		maps[0]->unmount(false);
+
+		for (int t = 0; t <= TABLES; t++) {
+			delete maps[t];
+		}
+	}
+}
@@ -36,6 +36,11 @@ void caseStartupShutdownWithDelKey();
 void caseStartupShutdownDelAll();
 void caseBigRead();
 void caseUnevenFile();
+void caseMemoryMapped();
+void caseStartupShutdownMemoryMapped();
+void caseDirectWrite();
+void caseStartupShutdownDirectWrite();
+void caseStartupShutdownHotSet();
 
 void caseCompressionLargeAlloc();
 
@@ -43,7 +48,7 @@ longtype  writeData();
 void readData(longtype position);
 
 void initFile();
-void startup(boolean del, boolean varValues = false);
+void startup(boolean del, boolean varValues = false, longtype extraOptions = 0);
 void shutdown();
 
 int main(int argc, char** argv) {
@@ -70,6 +75,14 @@ int main(int argc, char** argv) {
 	caseBigRead();
 	caseUnevenFile();
 
+	caseMemoryMapped();
+	caseStartupShutdownMemoryMapped();
+
+	caseDirectWrite();
+	caseStartupShutdownDirectWrite();
+
+	caseStartupShutdownHotSet();
+
 	caseCompressionLargeAlloc();
 
 	return 0;
@@ -665,6 +678,320 @@ void caseUnevenFile() {
 	delete file;
 }
 
+void caseMemoryMapped() {
+	DEEP_LOG(INFO, OTHER, " TEST CASE - MEMORY MAPPED\n");
+	initFile();
+
+	DEEP_LOG(INFO, OTHER, " WRITING MIXED DATA - %d BYTES WITH %d BYTE BUFFER\n", BUFFER_SIZE * MULTIPLIER, BUFFER_SIZE);
+	longtype pos1 = writeData();
+	braFile->flush();
+
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_WRITE);
+	longtype pos2 = writeData();
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_NONE);
+	braFile->flush();
+
+	BufferedRandomAccessFile* writer = braFile;
+
+	braFile = new BufferedRandomAccessFile(file, "r", BUFFER_SIZE);
+	braFile->setMemoryMapped(true);
+	braFile->setWriter(writer);
+	braFile->setOnline(true);
+
+	if (braFile->isMapped() == false) {
+		DEEP_LOG(ERROR, OTHER, " FAILED MAPPING\n");
+		exit(-1);
+	}
+
+	DEEP_LOG(INFO, OTHER, " VERIFYING MAPPED DATA\n");
+	readData(pos1);
+
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_READ);
+	readData(pos2);
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_NONE);
+
+	readData(pos1);
+
+	DEEP_LOG(INFO, OTHER, " VERIFYING MAPPED DATA AFTER GROWTH\n");
+	BufferedRandomAccessFile* reader = braFile;
+	braFile = writer;
+	longtype pos3 = writeData();
+	braFile->flush();
+	braFile = reader;
+
+	readData(pos3);
+	readData(pos1);
+
+	if (braFile->isMapped() == false) {
+		DEEP_LOG(ERROR, OTHER, " FAILED REMAPPING\n");
+		exit(-1);
+	}
+
+	DEEP_LOG(INFO, OTHER, " SUCCESS\n");
+
+	delete braFile;
+	braFile = writer;
+
+	file->clobber();
+	delete braFile;
+	delete file;
+}
+
+void caseStartupShutdownMemoryMapped() {
+
+	DEEP_LOG(INFO, OTHER, " TEST CASE - STARTUP SHUTDOWN MEMORY MAPPED MAP\n");
+	startup(true, false, RealTimeMap<int>::O_MEMORYMAP);
+
+	Transaction* tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	nbyte data(sizeof(int));
+	for (int x = 0; x < 10000; x++) {
+		memcpy((bytearray) data, &x, sizeof(int));
+		MAP->put(x, &data, RealTimeMap<int>::UNIQUE, tx);
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+	DEEP_LOG(INFO, OTHER, " SLEEPING 3 SECONDS FOR SHUTDOWN...\n");
+	Thread::sleep(3000);
+	startup(false, false, RealTimeMap<int>::O_MEMORYMAP);
+
+	tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	int retKey;
+	for (int x = 0; x < 10000; x++) {
+		if (MAP->get(x, &data, RealTimeMap<int>::EXACT, &retKey, tx, RealTimeMap<int>::LOCK_NONE, null) == false) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ EXPECTED: [%d] GOT NOTHING\n", x);
+			exit(-1);
+		}
+
+		if (memcmp((bytearray) data, &x, sizeof(int)) != 0) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ VALUE AT: [%d]\n", x);
+			exit(-1);
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+
+	DEEP_LOG(INFO, OTHER, " SUCCESS\n");
+}
+
+void caseDirectWrite() {
+	DEEP_LOG(INFO, OTHER, " TEST CASE - DIRECT WRITE\n");
+	initFile();
+
+	// XXX: leave the file unaligned so the first direct block reads back its head
+	longtype pos1 = writeData();
+	braFile->flush();
+
+	braFile->setDirectWrite(true);
+	if (braFile->getDirectWrite() == false) {
+		DEEP_LOG(WARN, OTHER, " DIRECT WRITE UNAVAILABLE ON THIS FILE SYSTEM\n");
+	}
+
+	DEEP_LOG(INFO, OTHER, " WRITING TAIL ONLY FLUSH\n");
+	longtype pos2 = writeData();
+	braFile->flush();
+
+	DEEP_LOG(INFO, OTHER, " WRITING ACROSS DIRECT BLOCKS\n");
+	longtype pos3 = braFile->getPosition();
+	inttype count = 1000;
+	for (inttype i = 0; i < count; i++) {
+		writeData();
+	}
+
+	braFile->flush();
+
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_WRITE);
+	longtype pos4 = writeData();
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_NONE);
+	braFile->flush();
+
+	if (braFile->length() != file->length()) {
+		DEEP_LOG(ERROR, OTHER, " FAILED FILE LENGTH, EXPECTED: [%lld] GOT: [%lld]\n", file->length(), braFile->length());
+		exit(-1);
+	}
+
+	BufferedRandomAccessFile* writer = braFile;
+
+	braFile = new BufferedRandomAccessFile(file, "r", BUFFER_SIZE);
+	braFile->setWriter(writer);
+	braFile->setOnline(true);
+
+	DEEP_LOG(INFO, OTHER, " VERIFYING DIRECT DATA\n");
+	readData(pos1);
+	readData(pos2);
+
+	for (inttype i = 0; i < count; i++) {
+		readData(pos3 + (i * BUFFER_SIZE * MULTIPLIER));
+	}
+
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_READ);
+	readData(pos4);
+	braFile->setCompress(BufferedRandomAccessFile::COMPRESS_NONE);
+
+	DEEP_LOG(INFO, OTHER, " SUCCESS\n");
+
+	delete braFile;
+	braFile = writer;
+
+	file->clobber();
+	delete braFile;
+	delete file;
+}
+
+void caseStartupShutdownDirectWrite() {
+
+	DEEP_LOG(INFO, OTHER, " TEST CASE - STARTUP SHUTDOWN DIRECT WRITE MAP\n");
+	startup(true, true, RealTimeMap<int>::O_DIRECTWRITE);
+
+	Transaction* tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	nbyte data(64);
+	for (int x = 0; x < 100000; x++) {
+		memset((bytearray) data, x & 0x7f, data.length);
+		memcpy((bytearray) data, &x, sizeof(int));
+		MAP->put(x, &data, RealTimeMap<int>::UNIQUE, tx);
+
+		if ((x % 10000) == 0) {
+			tx->commit(tx->getLevel());
+			tx->begin();
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+	DEEP_LOG(INFO, OTHER, " SLEEPING 3 SECONDS FOR SHUTDOWN...\n");
+	Thread::sleep(3000);
+	startup(false, true, RealTimeMap<int>::O_DIRECTWRITE);
+
+	tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	nbyte value(64);
+	int retKey;
+	for (int x = 0; x < 100000; x++) {
+		if (MAP->get(x, &value, RealTimeMap<int>::EXACT, &retKey, tx, RealTimeMap<int>::LOCK_NONE, null) == false) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ EXPECTED: [%d] GOT NOTHING\n", x);
+			exit(-1);
+		}
+
+		memset((bytearray) data, x & 0x7f, data.length);
+		memcpy((bytearray) data, &x, sizeof(int));
+		if ((value.length != data.length) || (memcmp((bytearray) value, (bytearray) data, data.length) != 0)) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ VALUE AT: [%d]\n", x);
+			exit(-1);
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+
+	DEEP_LOG(INFO, OTHER, " SUCCESS\n");
+}
+
+void caseStartupShutdownHotSet() {
+
+	DEEP_LOG(INFO, OTHER, " TEST CASE - STARTUP SHUTDOWN HOT SET MAP\n");
+	startup(true, false, RealTimeMap<int>::O_PREFETCH);
+
+	Transaction* tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	nbyte data(sizeof(int));
+	for (int x = 0; x < 100000; x++) {
+		memcpy((bytearray) data, &x, sizeof(int));
+		MAP->put(x, &data, RealTimeMap<int>::UNIQUE, tx);
+
+		if ((x % 10000) == 0) {
+			tx->commit(tx->getLevel());
+			tx->begin();
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	tx->begin();
+
+	// XXX: heat up the tail of the key range
+	int retKey;
+	for (int i = 0; i < 4; i++) {
+		for (int x = 90000; x < 100000; x++) {
+			MAP->get(x, &data, RealTimeMap<int>::EXACT, &retKey, tx, RealTimeMap<int>::LOCK_NONE, null);
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+
+	if (FileUtil::exists("./datastore.hrt") == false) {
+		DEEP_LOG(ERROR, OTHER, " FAILED HOT SET NOT RECORDED\n");
+		exit(-1);
+	}
+
+	DEEP_LOG(INFO, OTHER, " SLEEPING 3 SECONDS FOR SHUTDOWN...\n");
+	Thread::sleep(3000);
+	startup(false, false, RealTimeMap<int>::O_PREFETCH);
+
+	DEEP_LOG(INFO, OTHER, " SLEEPING 3 SECONDS FOR PREWARM...\n");
+	Thread::sleep(3000);
+
+	tx = Transaction::create();
+	tx->begin();
+	MAP->associate(tx);
+
+	nbyte value(sizeof(int));
+	for (int x = 0; x < 100000; x++) {
+		if (MAP->get(x, &value, RealTimeMap<int>::EXACT, &retKey, tx, RealTimeMap<int>::LOCK_NONE, null) == false) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ EXPECTED: [%d] GOT NOTHING\n", x);
+			exit(-1);
+		}
+
+		memcpy((bytearray) data, &x, sizeof(int));
+		if (memcmp((bytearray) value, (bytearray) data, sizeof(int)) != 0) {
+			DEEP_LOG(ERROR, OTHER, " FAILED READ VALUE AT: [%d]\n", x);
+			exit(-1);
+		}
+	}
+
+	tx->commit(tx->getLevel());
+	Transaction::destroy(tx);
+
+	shutdown();
+
+	// XXX: hot set survives a restart and is removed with the map files
+	if (FileUtil::exists("./datastore.hrt") == false) {
+		DEEP_LOG(ERROR, OTHER, " FAILED HOT SET NOT KEPT\n");
+		exit(-1);
+	}
+
+	MapFileUtil::clobber("./datastore");
+	if (FileUtil::exists("./datastore.hrt") == true) {
+		DEEP_LOG(ERROR, OTHER, " FAILED HOT SET NOT CLOBBERED\n");
+		exit(-1);
+	}
+
+	DEEP_LOG(INFO, OTHER, " SUCCESS\n");
+}
+
 void caseCompressionLargeAlloc() {
 	DEEP_LOG(INFO, OTHER, " TEST CASE - COMPRESSION LARGE ALLOC\n");
 	ulongtype cacheSizeBefore = Properties::getCacheSize();
@@ -806,7 +1133,7 @@ void initFile() {
         braFile->setOnline(true);
 }	
 
-void startup(boolean del, boolean varCompValues) {
+void startup(boolean del, boolean varCompValues, longtype extraOptions) {
 
 	DEEP_LOG(INFO, OTHER, " STARTUP MAP\n");
 
@@ -817,6 +1144,8 @@ void startup(boolean del, boolean varCompValues) {
 		options |= RealTimeMap<int>::O_VALUECOMPRESS;
 	}
 
+	options |= extraOptions;
+
         if (del == true) {
                 options |= RealTimeMap<int>::O_DELETE;
         }
@@ -33,6 +33,7 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 
 #include "cxx/lang/Object.h"
 #include "cxx/io/EOFException.h"
@@ -93,6 +94,43 @@ class FileDescriptor : public Object {
 			}
 		}
 
+		FORCE_INLINE void write(const voidarray data, longtype bytes, longtype offset) const {
+			bytearray buffer = (bytearray) data;
+
+			while (bytes > 0) {
+				ssize_t count = pwrite(m_fileno, buffer, bytes, offset);
+				if (count < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+
+					LOGGING_ERROR("Invalid write (pwrite): %d\n", errno);
+					throw IOException();
+				}
+
+				buffer += count;
+				offset += count;
+				bytes -= count;
+			}
+		}
+
+		FORCE_INLINE voidarray map(longtype bytes) const {
+			voidarray address = mmap(null, bytes, PROT_READ, MAP_SHARED, m_fileno, 0);
+			if (address == MAP_FAILED) {
+				LOGGING_ERROR("Invalid map (mmap): %d\n", errno);
+				throw IOException();
+			}
+
+			return address;
+		}
+
+		FORCE_INLINE static void unmap(voidarray address, longtype bytes) {
+			if (munmap(address, bytes) != 0) {
+				LOGGING_ERROR("Invalid unmap (munmap): %d\n", errno);
+				throw IOException();
+			}
+		}
+
 		FORCE_INLINE boolean valid() const {
 			return (ftell(m_handle) != -1);
 		}
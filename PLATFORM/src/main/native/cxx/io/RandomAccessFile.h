@@ -360,6 +360,8 @@ class RandomAccessFile : public Object {
 		inline virtual void write(const nbyte* b);
 		inline virtual void write(const nbyte* b, inttype off, inttype len);
 
+		inline void positionalWrite(const nbyte* b, inttype off, inttype len, longtype pos);
+
 		inline virtual void setLength(longtype newLength, boolean modify = true);
 		inline virtual inttype skipBytes(inttype n, boolean* eof = null);
 
@@ -552,6 +554,22 @@ inline void RandomAccessFile::write(const nbyte* b, inttype off, inttype len) {
 	m_falloc_lock.unlock();
 }
 
+// XXX: single pwrite at pos, the stdio file pointer is not moved
+inline void RandomAccessFile::positionalWrite(const nbyte* b, inttype off, inttype len, longtype pos) {
+	CXX_LANG_MEMORY_DEBUG_ASSERT(this);
+	m_falloc_lock.lock();
+	{
+		fflush(m_handle);
+
+		getFD()->write(*b + off, len, pos);
+
+		if (m_length < (pos + len)) {
+			m_length = pos + len;
+		}
+	}
+	m_falloc_lock.unlock();
+}
+
 inline void RandomAccessFile::setLength(longtype newLength, boolean modify) {
 	CXX_LANG_MEMORY_DEBUG_ASSERT(this);
 	if (modify == true) {
@@ -25,6 +25,10 @@
  *    exception statement from all source files in the program, then also delete
  *    it in the license file.
  */
+#include <stdarg.h>
+#include <unistd.h>
+#include <pthread.h>
+
 #include "cxx/util/Logger.h"
 
 using namespace cxx::util;
@@ -80,3 +84,276 @@ const char* Logger::topicStrings[] = {
 					"OTHER",
 					"LCNSE",
 					null};
+
+// XXX: per-thread single producer / single consumer ring of formatted messages (i.e. no locks or syscalls on the logging thread)
+struct LogRing {
+
+	static const uinttype SLOTS = 128;
+	static const uinttype TEXT_SIZE = 496;
+
+	struct Slot {
+		time_t m_time;
+		uinttype m_length;
+		char m_text[TEXT_SIZE];
+	};
+
+	// XXX: producer and consumer indexes on separate cache lines
+	volatile uinttype m_head;
+	volatile ulongtype m_dropped;
+	char m_pad[64 - sizeof(ulongtype) - sizeof(ulongtype)];
+
+	volatile uinttype m_tail;
+	ulongtype m_reported;
+
+	// XXX: released when the owning thread exits and claimed again by the next new thread (i.e. rings are never freed)
+	volatile uinttype m_owned;
+	LogRing* m_next;
+
+	Slot m_slots[SLOTS];
+
+	LogRing(void):
+		m_head(0),
+		m_dropped(0),
+		m_tail(0),
+		m_reported(0),
+		m_owned(1),
+		m_next(null) {
+	}
+
+	// XXX: returns false when the message does not fit a slot (i.e. caller writes it synchronously)
+	inline boolean offer(const char* format, va_list args) {
+		const uinttype head = m_head;
+		if ((head - m_tail) == SLOTS) {
+			m_dropped++;
+			return true;
+		}
+
+		Slot& slot = m_slots[head % SLOTS];
+
+		const inttype length = vsnprintf(slot.m_text, TEXT_SIZE, format, args);
+		if ((length < 0) || (length >= (inttype) TEXT_SIZE)) {
+			return false;
+		}
+
+		slot.m_time = time(null);
+		slot.m_length = length;
+
+		__sync_synchronize();
+		m_head = head + 1;
+
+		return true;
+	}
+};
+
+static LogRing* volatile s_rings = null;
+static __thread LogRing* s_ring = null;
+
+static pthread_key_t s_ringKey;
+static pthread_once_t s_ringOnce = PTHREAD_ONCE_INIT;
+
+static volatile boolean s_async = false;
+static volatile boolean s_stopping = false;
+static volatile uinttype s_pending = 0;
+static volatile ulongtype s_written = 0;
+
+static pthread_t s_writer;
+static pthread_mutex_t s_asyncLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void releaseRing(void* ring) {
+	__sync_synchronize();
+	((LogRing*) ring)->m_owned = 0;
+}
+
+static void createRingKey(void) {
+	pthread_key_create(&s_ringKey, releaseRing);
+}
+
+static LogRing* acquireRing(void) {
+	pthread_once(&s_ringOnce, createRingKey);
+
+	LogRing* ring = null;
+	for (LogRing* r = s_rings; r != null; r = r->m_next) {
+		if ((r->m_owned == 0) && (__sync_bool_compare_and_swap(&r->m_owned, 0, 1) == true)) {
+			ring = r;
+			break;
+		}
+	}
+
+	if (ring == null) {
+		ring = new LogRing();
+
+		do {
+			ring->m_next = s_rings;
+		} while (__sync_bool_compare_and_swap(&s_rings, ring->m_next, ring) == false);
+	}
+
+	pthread_setspecific(s_ringKey, ring);
+	s_ring = ring;
+
+	return ring;
+}
+
+static void writeDate(time_t tv, char* date, int size) {
+	struct tm tm;
+	if ((localtime_r(&tv, &tm) == null) || (strftime(date, size, "%b %d %Y %H:%M:%S", &tm) == 0)) {
+		date[0] = '\0';
+	}
+}
+
+// XXX: single consumer for every ring, returns whether anything was written
+static boolean drainRings(void) {
+	static time_t s_dateTime = 0;
+	static char s_date[25] = "";
+
+	boolean written = false;
+
+	for (LogRing* ring = s_rings; ring != null; ring = ring->m_next) {
+		const ulongtype dropped = ring->m_dropped;
+		if (dropped != ring->m_reported) {
+			char date[25];
+			writeDate(time(null), date, sizeof(date));
+
+			fprintf(stdout, "%s %c[%d;%dm[WARN]%c[%dm  %25.*s:%06d - (%s): logger dropped %llu messages (ring full)\n", date, 27,1,35,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::OTHER), dropped - ring->m_reported);
+
+			ring->m_reported = dropped;
+			written = true;
+		}
+
+		uinttype tail = ring->m_tail;
+		const uinttype head = ring->m_head;
+		__sync_synchronize();
+
+		for (; tail != head; tail++) {
+			const LogRing::Slot& slot = ring->m_slots[tail % LogRing::SLOTS];
+
+			if (slot.m_time != s_dateTime) {
+				writeDate(slot.m_time, s_date, sizeof(s_date));
+				s_dateTime = slot.m_time;
+			}
+
+			fputs(s_date, stdout);
+			fputc(' ', stdout);
+			fwrite(slot.m_text, 1, slot.m_length, stdout);
+
+			s_written++;
+			written = true;
+		}
+
+		__sync_synchronize();
+		ring->m_tail = tail;
+	}
+
+	if (written == true) {
+		fflush(stdout);
+	}
+
+	return written;
+}
+
+static void* writeRings(void*) {
+	while (s_stopping == false) {
+		if (drainRings() == false) {
+			usleep(1000 /* 1 ms */);
+		}
+	}
+
+	drainRings();
+
+	return null;
+}
+
+void Logger::print(Level level, const char* format, ...) {
+	va_list args;
+
+	if ((s_async == true) && (level != ERROR)) {
+		boolean queued = false;
+
+		// XXX: pending keeps stopAsync from draining while a message is being placed
+		__sync_add_and_fetch(&s_pending, 1);
+		if (s_async == true) {
+			LogRing* ring = s_ring;
+			if (ring == null) {
+				ring = acquireRing();
+			}
+
+			va_start(args, format);
+			queued = ring->offer(format, args);
+			va_end(args);
+		}
+		__sync_sub_and_fetch(&s_pending, 1);
+
+		if (queued == true) {
+			return;
+		}
+	}
+
+	char date[25];
+	Logger::getDate(date, 25);
+
+	flockfile(stdout);
+	{
+		fputs(date, stdout);
+		fputc(' ', stdout);
+
+		va_start(args, format);
+		vfprintf(stdout, format, args);
+		va_end(args);
+	}
+	funlockfile(stdout);
+}
+
+void Logger::startAsync(void) {
+	static boolean s_registered = false;
+
+	pthread_mutex_lock(&s_asyncLock);
+	{
+		if (s_async == false) {
+			s_stopping = false;
+
+			if (pthread_create(&s_writer, null, writeRings, null) == 0) {
+				if (s_registered == false) {
+					// XXX: drain anything still queued at process exit
+					atexit(Logger::stopAsync);
+					s_registered = true;
+				}
+
+				s_async = true;
+			}
+		}
+	}
+	pthread_mutex_unlock(&s_asyncLock);
+}
+
+void Logger::stopAsync(void) {
+	pthread_mutex_lock(&s_asyncLock);
+	{
+		if (s_async == true) {
+			s_async = false;
+
+			while (s_pending != 0) {
+				sched_yield();
+			}
+
+			s_stopping = true;
+			pthread_join(s_writer, null);
+		}
+	}
+	pthread_mutex_unlock(&s_asyncLock);
+}
+
+boolean Logger::isAsync(void) {
+	return s_async;
+}
+
+ulongtype Logger::getWritten(void) {
+	return s_written;
+}
+
+ulongtype Logger::getDropped(void) {
+	ulongtype dropped = 0;
+	for (LogRing* ring = s_rings; ring != null; ring = ring->m_next) {
+		dropped += ring->m_dropped;
+	}
+
+	return dropped;
+}
@@ -56,60 +56,44 @@ namespace cxx { namespace util {
 
 	#define DEEP_LOG_INFO(TOPIC,format,...)																\
 		if (Logger::isLevelEnabled(Logger::INFO) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[INFO]%c[%dm  %25.*s:%06d - (%s): " format, date, 27,1,32,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
+			Logger::print(Logger::INFO, "%c[%d;%dm[INFO]%c[%dm  %25.*s:%06d - (%s): " format, 27,1,32,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
 		}
 
 	#define DEEP_LOG_WARN(TOPIC,format,...)																\
 		if (Logger::isLevelEnabled(Logger::WARN) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[WARN]%c[%dm  %25.*s:%06d - (%s): " format, date, 27,1,35,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
+			Logger::print(Logger::WARN, "%c[%d;%dm[WARN]%c[%dm  %25.*s:%06d - (%s): " format, 27,1,35,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
 		}
 
 	#define DEEP_LOG_ERROR(TOPIC,format,...)															\
 		if (Logger::isLevelEnabled(Logger::ERROR) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[ERROR]%c[%dm %25.*s:%06d - (%s): " format, date, 27,1,31,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
+			Logger::print(Logger::ERROR, "%c[%d;%dm[ERROR]%c[%dm %25.*s:%06d - (%s): " format, 27,1,31,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
 		}
 
 	#define DEEP_LOG_DEBUG(TOPIC,format,...)															\
 		if (Logger::isLevelEnabled(Logger::DEBUG) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[DEBUG]%c[%dm %25.*s:%06d - (%s): " format, date, 27,1,33,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
+			Logger::print(Logger::DEBUG, "%c[%d;%dm[DEBUG]%c[%dm %25.*s:%06d - (%s): " format, 27,1,33,27,0, 25, Logger::getName(__FILE__), __LINE__, Logger::topicToString(Logger::TOPIC), ##__VA_ARGS__);	\
 		}
 
 // XXX: old logging formats
 
 	#define LOGGING_INFO(format,...) 																\
 		if (Logger::isLevelEnabled(Logger::INFO) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[INFO]%c[%dm  %25.*s:%06d - " format, date, 27,1,32,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
+			Logger::print(Logger::INFO, "%c[%d;%dm[INFO]%c[%dm  %25.*s:%06d - " format, 27,1,32,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
 		}
 
 	#define LOGGING_WARN(format,...) 																\
 		if (Logger::isLevelEnabled(Logger::WARN) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[WARN]%c[%dm  %25.*s:%06d - " format, date, 27,1,35,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
+			Logger::print(Logger::WARN, "%c[%d;%dm[WARN]%c[%dm  %25.*s:%06d - " format, 27,1,35,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
 		}
 
 	#define LOGGING_ERROR(format,...) 																\
 		if (Logger::isLevelEnabled(Logger::ERROR) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[ERROR]%c[%dm %25.*s:%06d - " format, date, 27,1,31,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
+			Logger::print(Logger::ERROR, "%c[%d;%dm[ERROR]%c[%dm %25.*s:%06d - " format, 27,1,31,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
 		}
 
 	#define LOGGING_DEBUG(format,...) 																\
 		if (Logger::isLevelEnabled(Logger::DEBUG) == true) {													\
-			char date[25];																	\
-			Logger::getDate(date, 25);															\
-			fprintf(stdout, "%s %c[%d;%dm[DEBUG]%c[%dm %25.*s:%06d - " format, date, 27,1,33,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
+			Logger::print(Logger::DEBUG, "%c[%d;%dm[DEBUG]%c[%dm %25.*s:%06d - " format, 27,1,33,27,0, 25, Logger::getName(__FILE__), __LINE__, ##__VA_ARGS__);	\
 		}
 
 #else
@@ -194,6 +178,18 @@ class Logger {
 		static boolean isTopicEnabled(Topic topic);
 		static void enableTopic(Topic topic);
 		static void disableTopic(Topic topic);	
+
+		// XXX: formatting and output (see startAsync)
+
+		static void print(Level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+		// XXX: asynchronous output, callers format into a per-thread ring and a writer thread adds the date and writes (errors stay synchronous)
+		static void startAsync(void);
+		static void stopAsync(void);
+		static boolean isAsync(void);
+
+		static ulongtype getWritten(void);
+		static ulongtype getDropped(void);
 };
 
 // XXX: levels
@@ -0,0 +1,243 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef CXX_UTIL_CONCURRENT_LOCKS_BIASEDREADWRITELOCK_H_
+#define CXX_UTIL_CONCURRENT_LOCKS_BIASEDREADWRITELOCK_H_
+
+#include <pthread.h>
+
+#include "cxx/util/concurrent/locks/Lock.h"
+#include "cxx/util/concurrent/locks/UserSpaceReadWriteLock.h"
+
+namespace cxx { namespace util { namespace concurrent { namespace locks {
+
+// XXX: drop-in for UserSpaceReadWriteLock (same api), reader biased (i.e. bravo) for read mostly locks
+// XXX: while biased, readers publish themselves in a process wide slot table instead of the shared reader count
+// XXX: writers revoke the bias and wait out the published readers, then bias stays off for a multiple of that cost
+class BiasedReadWriteLock {
+	private:
+		// XXX: process wide visible reader table (shared by all biased locks)
+		static const uinttype SLOTS = 4096;
+
+		// XXX: number of fast read locks a thread can hold at once, beyond which reads take the underlying lock
+		static const uinttype HELD = 8;
+
+		// XXX: bias is inhibited for this multiple of the last revocation cost
+		static const ulongtype INHIBIT_MULTIPLIER = 9;
+
+		struct Held {
+			const BiasedReadWriteLock* m_locks[HELD];
+			uinttype m_depth[HELD];
+		};
+
+		UserSpaceReadWriteLock m_lock;
+
+		volatile boolean m_readBias;
+		volatile ulongtype m_inhibitUntil;
+
+		FORCE_INLINE static const BiasedReadWriteLock* volatile* slots(void) {
+			static const BiasedReadWriteLock* volatile s_slots[SLOTS];
+
+			return s_slots;
+		}
+
+		FORCE_INLINE static Held* held(void) {
+			static __thread Held s_held;
+
+			return &s_held;
+		}
+
+		FORCE_INLINE static ulongtype ticks(void) {
+			return __builtin_ia32_rdtsc();
+		}
+
+		FORCE_INLINE const BiasedReadWriteLock* volatile* slot(void) const {
+			ulongtype hash = ((ulongtype) pthread_self()) ^ (((ulongtype) this) >> 6);
+			hash *= 0x9e3779b97f4a7c15ULL;
+
+			return &slots()[(hash >> 32) % SLOTS];
+		}
+
+		FORCE_INLINE boolean tryFastRead(void) {
+			Held* h = held();
+
+			// XXX: nested reads of a fast held lock stay fast, even once revoked (i.e. the revoking writer is waiting on this reader)
+			for (uinttype i = 0; i < HELD; i++) {
+				if (h->m_locks[i] == this) {
+					h->m_depth[i]++;
+					return true;
+				}
+			}
+
+			if (m_readBias == false) {
+				return false;
+			}
+
+			for (uinttype i = 0; i < HELD; i++) {
+				if (h->m_locks[i] != null) {
+					continue;
+				}
+
+				const BiasedReadWriteLock* volatile* s = slot();
+				if (__sync_bool_compare_and_swap(s, (const BiasedReadWriteLock*) null, this) == false) {
+					return false;
+				}
+
+				// XXX: publish first, then check bias (see revoke)
+				if (m_readBias == true) {
+					h->m_locks[i] = this;
+					h->m_depth[i] = 1;
+					return true;
+				}
+
+				*s = null;
+				return false;
+			}
+
+			return false;
+		}
+
+		FORCE_INLINE boolean fastReadUnlock(void) {
+			Held* h = held();
+			for (uinttype i = 0; i < HELD; i++) {
+				if (h->m_locks[i] == this) {
+					if (--h->m_depth[i] != 0) {
+						return true;
+					}
+
+					h->m_locks[i] = null;
+
+					__sync_synchronize();
+					*slot() = null;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		FORCE_INLINE void biasRead(void) {
+			// XXX: called under the underlying read lock (i.e. no writer can be revoking)
+			if ((m_readBias == false) && (ticks() >= m_inhibitUntil)) {
+				m_readBias = true;
+			}
+		}
+
+		FORCE_INLINE boolean revoke(boolean wait) {
+			if (m_readBias == false) {
+				return true;
+			}
+
+			m_readBias = false;
+			__sync_synchronize();
+
+			const ulongtype start = ticks();
+			const BiasedReadWriteLock* volatile* s = slots();
+			for (uinttype i = 0; i < SLOTS; i++) {
+				uinttype state = 1;
+				while (s[i] == this) {
+					if (wait == false) {
+						m_inhibitUntil = ticks();
+						return false;
+					}
+
+					Lock::yield(&state);
+				}
+			}
+
+			const ulongtype now = ticks();
+			m_inhibitUntil = now + ((now - start) * INHIBIT_MULTIPLIER);
+
+			return true;
+		}
+
+	public:
+		BiasedReadWriteLock() :
+			m_lock(),
+			m_readBias(true),
+			m_inhibitUntil(0) {
+		}
+
+		virtual ~BiasedReadWriteLock() {
+			// XXX: nothing to do
+		}
+
+		FORCE_INLINE void readLock() {
+			if (tryFastRead() == true) {
+				return;
+			}
+
+			m_lock.readLock();
+			biasRead();
+		}
+
+		FORCE_INLINE boolean tryReadLock() {
+			if (tryFastRead() == true) {
+				return true;
+			}
+
+			if (m_lock.tryReadLock() == false) {
+				return false;
+			}
+
+			biasRead();
+			return true;
+		}
+
+		FORCE_INLINE void readUnlock() {
+			if (fastReadUnlock() == false) {
+				m_lock.readUnlock();
+			}
+		}
+
+		FORCE_INLINE void writeLock() {
+			m_lock.writeLock();
+			revoke(true /* wait */);
+		}
+
+		FORCE_INLINE boolean tryWriteLock() {
+			if (m_lock.tryWriteLock() == false) {
+				return false;
+			}
+
+			// XXX: bias stays revoked, readers arriving now take the underlying lock
+			if (revoke(false /* wait */) == false) {
+				m_lock.writeUnlock();
+				return false;
+			}
+
+			return true;
+		}
+
+		FORCE_INLINE void writeUnlock() {
+			m_lock.writeUnlock();
+		}
+};
+
+} } } } // namespace
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef CXX_UTIL_CONCURRENT_LOCKS_FUTEXLOCK_H_
+#define CXX_UTIL_CONCURRENT_LOCKS_FUTEXLOCK_H_ 
+
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "cxx/util/concurrent/locks/Lock.h"
+
+namespace cxx { namespace util { namespace concurrent { namespace locks {
+
+// XXX: drop-in for UserSpaceLock (same api), spins on a read with backoff and then parks in the kernel instead of yielding
+class FutexLock /* : public Lock */ {
+
+	private:
+		static const inttype UNLOCKED = 0;
+		static const inttype LOCKED = 1;
+		static const inttype CONTENDED = 2;
+
+		// XXX: backoff doubles from one pause up to 2^SPIN_ROUNDS pauses before parking
+		static const uinttype SPIN_ROUNDS = 10;
+
+		volatile inttype m_state;
+
+		FORCE_INLINE void wait(void) {
+			syscall(SYS_futex, &m_state, FUTEX_WAIT_PRIVATE, CONTENDED, null, null, 0);
+		}
+
+		FORCE_INLINE void wake(void) {
+			syscall(SYS_futex, &m_state, FUTEX_WAKE_PRIVATE, 1, null, null, 0);
+		}
+
+	public:
+		inline FutexLock(void):
+			m_state(UNLOCKED) {
+		}
+
+		FORCE_INLINE void lock() {
+			if (__sync_val_compare_and_swap(&m_state, UNLOCKED, LOCKED) == UNLOCKED) {
+				return;
+			}
+
+			// XXX: test-and-test-and-set, only attempt the bus lock once the holder has released
+			for (uinttype round = 0; round < SPIN_ROUNDS; round++) {
+				for (uinttype i = 0; i < (1U << round); i++) {
+					__asm volatile ("pause");
+				}
+
+				if ((m_state == UNLOCKED) && (__sync_val_compare_and_swap(&m_state, UNLOCKED, LOCKED) == UNLOCKED)) {
+					return;
+				}
+			}
+
+			// XXX: once contended, the lock is always taken as contended since other waiters may still be parked
+			while (__sync_lock_test_and_set(&m_state, CONTENDED) != UNLOCKED) {
+				wait();
+			}
+		}
+
+		FORCE_INLINE boolean tryLock() {
+			return (__sync_val_compare_and_swap(&m_state, UNLOCKED, LOCKED) == UNLOCKED);
+		}
+
+		FORCE_INLINE void unlock() {
+			if (__sync_lock_test_and_set(&m_state, UNLOCKED) == CONTENDED) {
+				wake();
+			}
+		}
+};
+
+} } } } // namespace
+
+#endif /*CXX_UTIL_CONCURRENT_LOCKS_FUTEXLOCK_H_*/
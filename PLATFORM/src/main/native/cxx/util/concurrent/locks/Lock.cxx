@@ -29,10 +29,14 @@
 #define CXX_UTIL_CONCURRENT_LOCKS_CXX_
 
 #include "cxx/util/concurrent/locks/Lock.h"
+#include "cxx/util/concurrent/locks/LockProfile.h"
 
 using namespace cxx::util::concurrent::locks;
 
 uinttype Lock::s_pause = Lock::PHYSICAL_PAUSE;
 uinttype Lock::s_yield = Lock::PHYSICAL_YIELD;
 
+boolean LockProfile::s_enabled = false;
+LockProfile::Site* volatile LockProfile::s_sites = null;
+
 #endif /*CXX_UTIL_CONCURRENT_LOCKS_CXX_*/
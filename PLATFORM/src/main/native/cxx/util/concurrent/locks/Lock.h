@@ -35,6 +35,10 @@
 
 #include "cxx/util/concurrent/Lockable.h"
 
+#ifdef DEEP_LOCK_STATS
+#include "cxx/util/concurrent/locks/LockProfile.h"
+#endif
+
 using namespace cxx::lang;
 using namespace cxx::util::concurrent;
 
@@ -77,6 +81,10 @@ class Lock : public Object, public Lockable {
 		}
 
 		FORCE_INLINE static void yield(uinttype* state) {
+			#ifdef DEEP_LOCK_STATS
+			(*LockProfile::spins())++;
+			#endif
+
 			if ((++(*state) % s_pause) == 0) {
 
 				/* XXX: schedule out, but wait a bit */
@@ -0,0 +1,207 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef CXX_UTIL_CONCURRENT_LOCKS_LOCKPROFILE_H_
+#define CXX_UTIL_CONCURRENT_LOCKS_LOCKPROFILE_H_ 
+
+#include <time.h>
+
+#include "cxx/lang/Object.h"
+
+using namespace cxx::lang;
+
+namespace cxx { namespace util { namespace concurrent { namespace locks {
+
+// XXX: lock contention statistics per lock site (see ProfiledLock), compiled in with DEEP_LOCK_STATS and gathered while enabled
+class LockProfile {
+
+	public:
+		// XXX: log2 nanosecond buckets (i.e. bucket n counts durations below 2^n ns)
+		static const uinttype BUCKETS = 36;
+
+		class Site {
+
+			private:
+				const char* m_name;
+				Site* m_next;
+
+				volatile ulongtype m_acquisitions;
+				volatile ulongtype m_contended;
+				volatile ulongtype m_spins;
+
+				volatile ulongtype m_wait[BUCKETS];
+				volatile ulongtype m_hold[BUCKETS];
+
+				FORCE_INLINE static uinttype bucket(ulongtype nanos) {
+					const uinttype b = (nanos == 0) ? 0 : (64 - __builtin_clzll(nanos));
+					return (b < BUCKETS) ? b : (BUCKETS - 1);
+				}
+
+				FORCE_INLINE static ulongtype percentile(const volatile ulongtype* histogram, ulongtype total, double p) {
+					if (total == 0) {
+						return 0;
+					}
+
+					const ulongtype rank = (ulongtype) (total * p);
+					ulongtype count = 0;
+					for (uinttype i = 0; i < BUCKETS; i++) {
+						count += histogram[i];
+						if (count > rank) {
+							return (1ULL << i);
+						}
+					}
+
+					return (1ULL << (BUCKETS - 1));
+				}
+
+				FORCE_INLINE static ulongtype sum(const volatile ulongtype* histogram) {
+					ulongtype total = 0;
+					for (uinttype i = 0; i < BUCKETS; i++) {
+						total += histogram[i];
+					}
+
+					return total;
+				}
+
+			public:
+				Site(const char* name):
+					m_name(name),
+					m_next(null),
+					m_acquisitions(0),
+					m_contended(0),
+					m_spins(0) {
+
+					reset();
+
+					// XXX: sites are static and never unregistered
+					do {
+						m_next = s_sites;
+					} while (__sync_bool_compare_and_swap(&s_sites, m_next, this) == false);
+				}
+
+				FORCE_INLINE const char* getName(void) const {
+					return m_name;
+				}
+
+				FORCE_INLINE Site* getNext(void) const {
+					return m_next;
+				}
+
+				FORCE_INLINE void acquired(void) {
+					__sync_add_and_fetch(&m_acquisitions, 1);
+				}
+
+				FORCE_INLINE void contended(ulongtype waited, ulongtype spins) {
+					__sync_add_and_fetch(&m_contended, 1);
+					__sync_add_and_fetch(&m_wait[bucket(waited)], 1);
+
+					if (spins != 0) {
+						__sync_add_and_fetch(&m_spins, spins);
+					}
+				}
+
+				FORCE_INLINE void held(ulongtype nanos) {
+					__sync_add_and_fetch(&m_hold[bucket(nanos)], 1);
+				}
+
+				FORCE_INLINE ulongtype getAcquisitions(void) const {
+					return m_acquisitions;
+				}
+
+				FORCE_INLINE ulongtype getContended(void) const {
+					return m_contended;
+				}
+
+				FORCE_INLINE ulongtype getSpins(void) const {
+					return m_spins;
+				}
+
+				FORCE_INLINE ulongtype getWait(double p) const {
+					return percentile(m_wait, sum(m_wait), p);
+				}
+
+				FORCE_INLINE ulongtype getHold(double p) const {
+					return percentile(m_hold, sum(m_hold), p);
+				}
+
+				FORCE_INLINE void reset(void) {
+					m_acquisitions = 0;
+					m_contended = 0;
+					m_spins = 0;
+
+					for (uinttype i = 0; i < BUCKETS; i++) {
+						m_wait[i] = 0;
+						m_hold[i] = 0;
+					}
+				}
+		};
+
+	private:
+		static boolean s_enabled;
+		static Site* volatile s_sites;
+
+	public:
+		FORCE_INLINE static void setEnabled(boolean enabled) {
+			s_enabled = enabled;
+		}
+
+		FORCE_INLINE static boolean getEnabled(void) {
+			return s_enabled;
+		}
+
+		FORCE_INLINE static Site* getSites(void) {
+			return s_sites;
+		}
+
+		FORCE_INLINE static ulongtype nanoTime(void) {
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			return (((ulongtype) ts.tv_sec) * 1000000000ULL) + ts.tv_nsec;
+		}
+
+		// XXX: yields of the calling thread (see Lock::yield), a profiled lock takes the difference across a contended acquisition
+		FORCE_INLINE static ulongtype* spins(void) {
+			static __thread ulongtype s_spins = 0;
+
+			return &s_spins;
+		}
+};
+
+} } } } // namespace
+
+#ifdef DEEP_LOCK_STATS
+	#define CXX_LOCK_SITE(tag, title) struct tag { FORCE_INLINE static const char* name(void) { return title; } };
+	#define CXX_PROFILED_LOCK(L, tag) cxx::util::concurrent::locks::ProfiledLock<L, tag>
+	#define CXX_PROFILED_READWRITE_LOCK(L, tag) cxx::util::concurrent::locks::ProfiledReadWriteLock<L, tag>
+#else
+	#define CXX_LOCK_SITE(tag, title)
+	#define CXX_PROFILED_LOCK(L, tag) L
+	#define CXX_PROFILED_READWRITE_LOCK(L, tag) L
+#endif
+
+#endif /*CXX_UTIL_CONCURRENT_LOCKS_LOCKPROFILE_H_*/
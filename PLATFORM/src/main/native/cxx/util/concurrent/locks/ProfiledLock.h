@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef CXX_UTIL_CONCURRENT_LOCKS_PROFILEDLOCK_H_
+#define CXX_UTIL_CONCURRENT_LOCKS_PROFILEDLOCK_H_ 
+
+#include "cxx/util/concurrent/locks/LockProfile.h"
+
+namespace cxx { namespace util { namespace concurrent { namespace locks {
+
+// XXX: wraps a lock (same api) and records acquisitions, contention, spins, wait and hold times under the site named by T::name()
+template<typename L, typename T>
+class ProfiledLock {
+
+	private:
+		static LockProfile::Site s_site;
+
+		L m_lock;
+		ulongtype m_start;
+		uinttype m_depth;
+
+		FORCE_INLINE void acquired(void) {
+			s_site.acquired();
+
+			// XXX: reentrant locks only time the outermost hold
+			if (m_depth++ == 0) {
+				m_start = LockProfile::nanoTime();
+			}
+		}
+
+	public:
+		inline ProfiledLock(void):
+			m_lock(),
+			m_start(0),
+			m_depth(0) {
+		}
+
+		template<typename A>
+		inline ProfiledLock(A arg):
+			m_lock(arg),
+			m_start(0),
+			m_depth(0) {
+		}
+
+		FORCE_INLINE void lock() {
+			if (LockProfile::getEnabled() == false) {
+				m_lock.lock();
+				return;
+			}
+
+			if (m_lock.tryLock() == false) {
+				const ulongtype spins = *LockProfile::spins();
+				const ulongtype start = LockProfile::nanoTime();
+
+				m_lock.lock();
+
+				s_site.contended(LockProfile::nanoTime() - start, *LockProfile::spins() - spins);
+			}
+
+			acquired();
+		}
+
+		FORCE_INLINE boolean tryLock() {
+			if (m_lock.tryLock() == false) {
+				return false;
+			}
+
+			if (LockProfile::getEnabled() == true) {
+				acquired();
+			}
+
+			return true;
+		}
+
+		FORCE_INLINE void unlock() {
+			if ((m_depth != 0) && (--m_depth == 0) && (LockProfile::getEnabled() == true)) {
+				s_site.held(LockProfile::nanoTime() - m_start);
+			}
+
+			m_lock.unlock();
+		}
+};
+
+template<typename L, typename T>
+LockProfile::Site ProfiledLock<L,T>::s_site(T::name());
+
+// XXX: read/write variant, read holds are shared and only their waits are recorded, write holds are timed
+template<typename L, typename T>
+class ProfiledReadWriteLock {
+
+	private:
+		static LockProfile::Site s_site;
+
+		L m_lock;
+		ulongtype m_start;
+
+	public:
+		inline ProfiledReadWriteLock(void):
+			m_lock(),
+			m_start(0) {
+		}
+
+		FORCE_INLINE void readLock() {
+			if (LockProfile::getEnabled() == false) {
+				m_lock.readLock();
+				return;
+			}
+
+			if (m_lock.tryReadLock() == false) {
+				const ulongtype spins = *LockProfile::spins();
+				const ulongtype start = LockProfile::nanoTime();
+
+				m_lock.readLock();
+
+				s_site.contended(LockProfile::nanoTime() - start, *LockProfile::spins() - spins);
+			}
+
+			s_site.acquired();
+		}
+
+		FORCE_INLINE boolean tryReadLock() {
+			if (m_lock.tryReadLock() == false) {
+				return false;
+			}
+
+			if (LockProfile::getEnabled() == true) {
+				s_site.acquired();
+			}
+
+			return true;
+		}
+
+		FORCE_INLINE void readUnlock() {
+			m_lock.readUnlock();
+		}
+
+		FORCE_INLINE void writeLock() {
+			if (LockProfile::getEnabled() == false) {
+				m_lock.writeLock();
+				m_start = 0;
+				return;
+			}
+
+			if (m_lock.tryWriteLock() == false) {
+				const ulongtype spins = *LockProfile::spins();
+				const ulongtype start = LockProfile::nanoTime();
+
+				m_lock.writeLock();
+
+				s_site.contended(LockProfile::nanoTime() - start, *LockProfile::spins() - spins);
+			}
+
+			s_site.acquired();
+			m_start = LockProfile::nanoTime();
+		}
+
+		FORCE_INLINE boolean tryWriteLock() {
+			if (m_lock.tryWriteLock() == false) {
+				return false;
+			}
+
+			if (LockProfile::getEnabled() == true) {
+				s_site.acquired();
+				m_start = LockProfile::nanoTime();
+
+			} else {
+				m_start = 0;
+			}
+
+			return true;
+		}
+
+		FORCE_INLINE void writeUnlock() {
+			if ((m_start != 0) && (LockProfile::getEnabled() == true)) {
+				s_site.held(LockProfile::nanoTime() - m_start);
+			}
+
+			m_lock.writeUnlock();
+		}
+};
+
+template<typename L, typename T>
+LockProfile::Site ProfiledReadWriteLock<L,T>::s_site(T::name());
+
+} } } } // namespace
+
+#endif /*CXX_UTIL_CONCURRENT_LOCKS_PROFILEDLOCK_H_*/
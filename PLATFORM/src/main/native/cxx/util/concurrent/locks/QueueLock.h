@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#ifndef CXX_UTIL_CONCURRENT_LOCKS_QUEUELOCK_H_
+#define CXX_UTIL_CONCURRENT_LOCKS_QUEUELOCK_H_ 
+
+#include <unistd.h>
+
+#include "cxx/lang/RuntimeException.h"
+
+#include "cxx/util/Logger.h"
+
+#include "cxx/util/concurrent/locks/Lock.h"
+
+namespace cxx { namespace util { namespace concurrent { namespace locks {
+
+// XXX: drop-in for UserSpaceLock (same api), mcs queue lock where each waiter spins on its own node and is handed the lock in order
+// XXX: unlike UserSpaceLock, it must be unlocked by the locking thread (i.e. queue nodes are thread local)
+class QueueLock /* : public Lock */ {
+
+	private:
+		struct Node {
+			Node* volatile m_next;
+			volatile boolean m_wait;
+		};
+
+		// XXX: number of queue locks a thread can hold (or wait on) at once
+		static const uinttype NODES = 32;
+
+		Node* volatile m_tail;
+		Node* m_owner;
+
+		FORCE_INLINE static Node* nodes(uinttype** slots) {
+			static __thread Node s_nodes[NODES];
+			static __thread uinttype s_slots = 0;
+
+			*slots = &s_slots;
+			return s_nodes;
+		}
+
+		FORCE_INLINE static Node* acquireNode(void) {
+			uinttype* slots = null;
+			Node* base = nodes(&slots);
+
+			if (*slots == (uinttype) ~0) {
+				DEEP_LOG(ERROR, OTHER, "Invalid lock, too many queue locks held: %u\n", NODES);
+
+				throw RuntimeException("Invalid lock, too many queue locks held.");
+			}
+
+			const uinttype slot = __builtin_ctz(~(*slots));
+			*slots |= (1U << slot);
+
+			Node* node = &base[slot];
+			node->m_next = null;
+			node->m_wait = true;
+
+			return node;
+		}
+
+		FORCE_INLINE static void releaseNode(Node* node) {
+			uinttype* slots = null;
+			Node* base = nodes(&slots);
+
+			*slots &= ~(1U << (node - base));
+		}
+
+	public:
+		inline QueueLock(void):
+			m_tail(null),
+			m_owner(null) {
+		}
+
+		FORCE_INLINE void lock() {
+			Node* node = acquireNode();
+
+			Node* prev = __sync_lock_test_and_set(&m_tail, node);
+			if (prev != null) {
+				prev->m_next = node;
+
+				uinttype state = 1;
+				while (node->m_wait == true) {
+					Lock::yield(&state);
+				}
+			}
+
+			m_owner = node;
+		}
+
+		FORCE_INLINE boolean tryLock() {
+			Node* node = acquireNode();
+
+			if (__sync_val_compare_and_swap(&m_tail, (Node*) null, node) != null) {
+				releaseNode(node);
+				return false;
+			}
+
+			m_owner = node;
+			return true;
+		}
+
+		FORCE_INLINE void unlock() {
+			Node* node = m_owner;
+
+			#ifdef DEEP_DEBUG
+			if (node == null) {
+				DEEP_LOG(ERROR, OTHER, "Invalid unlock, already unlocked.\n");
+
+				throw RuntimeException("Invalid unlock, already unlocked.");
+			}
+			#endif
+
+			m_owner = null;
+
+			if (node->m_next == null) {
+				if (__sync_val_compare_and_swap(&m_tail, node, (Node*) null) == node) {
+					releaseNode(node);
+					return;
+				}
+
+				// XXX: a waiter swapped in behind this node, but has not yet linked itself
+				uinttype state = 1;
+				while (node->m_next == null) {
+					Lock::yield(&state);
+				}
+			}
+
+			node->m_next->m_wait = false;
+
+			releaseNode(node);
+		}
+};
+
+} } } } // namespace
+
+#endif /*CXX_UTIL_CONCURRENT_LOCKS_QUEUELOCK_H_*/
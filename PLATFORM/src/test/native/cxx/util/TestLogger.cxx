@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2010 Deep Software Foundation
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+#include <stdio.h>
+#include <cstdlib>
+#include <string.h>
+
+#include "cxx/lang/Thread.h"
+#include "cxx/lang/Runnable.h"
+
+#include "cxx/util/Logger.h"
+
+#include "cxx/util/concurrent/atomic/AtomicInteger.h"
+
+using namespace cxx::lang;
+using namespace cxx::util;
+using namespace cxx::util::concurrent::atomic;
+
+static int NUM_THREADS = 8;
+static int COUNT = 5000;
+
+static AtomicInteger CLIENTS_RUNNING;
+
+class TestThread : public Runnable {
+
+	private:
+		int m_num;
+
+	public:
+		TestThread(int num) :
+			m_num(num) {
+		}
+
+		virtual void run() {
+			for (int i = 0; i < COUNT; i++) {
+				DEEP_LOG(DEBUG, OTHER, "client: %d, message: %d\n", m_num, i);
+
+				if ((i % 100) == 0) {
+					Thread::sleep(1);
+				}
+			}
+
+			CLIENTS_RUNNING.getAndDecrement();
+		}
+};
+
+void testAsync(void) {
+
+	TestThread** clients = new TestThread*[NUM_THREADS];
+	Thread** threads = new Thread*[NUM_THREADS];
+
+	const ulongtype written = Logger::getWritten();
+	const ulongtype dropped = Logger::getDropped();
+
+	Logger::startAsync();
+	if (Logger::isAsync() == false) {
+		printf("- FAILED: async not started\n");
+		exit(-1);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		CLIENTS_RUNNING.getAndIncrement();
+
+		clients[i] = new TestThread(i);
+		threads[i] = new Thread(clients[i]);
+		threads[i]->start();
+	}
+
+	// XXX: oversized messages bypass the ring (i.e. not counted as written)
+	char large[1024];
+	memset(large, 'x', sizeof(large) - 1);
+	large[sizeof(large) - 1] = '\0';
+	DEEP_LOG(DEBUG, OTHER, "large: %s\n", large);
+
+	while (CLIENTS_RUNNING.get() > 0) {
+		Thread::sleep(10);
+	}
+
+	Logger::stopAsync();
+	if (Logger::isAsync() == true) {
+		printf("- FAILED: async not stopped\n");
+		exit(-1);
+	}
+
+	const ulongtype total = (Logger::getWritten() - written) + (Logger::getDropped() - dropped);
+
+	printf("\n -- written: %llu, dropped: %llu\n\n", Logger::getWritten() - written, Logger::getDropped() - dropped);
+
+	if (total != (ulongtype) (NUM_THREADS * COUNT)) {
+		printf("- FAILED: expected %d messages, found %llu\n", NUM_THREADS * COUNT, total);
+		exit(-1);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		delete clients[i];
+		delete threads[i];
+	}
+
+	delete [] clients;
+	delete [] threads;
+}
+
+int main(int argc, char** argv) {
+
+	Logger::enableLevel(Logger::DEBUG);
+
+	// XXX: second pass restarts the writer and reuses rings released by exited threads
+	testAsync();
+	testAsync();
+
+	DEEP_LOG(INFO, OTHER, "synchronous after stop\n");
+
+	return 0;
+}
@@ -34,6 +34,7 @@
 #include "cxx/lang/Runnable.h"
 
 #include "cxx/util/concurrent/atomic/AtomicInteger.h"
+#include "cxx/util/concurrent/locks/BiasedReadWriteLock.h"
 #include "cxx/util/concurrent/locks/ReentrantReadWriteLock.h"
 #include "cxx/util/concurrent/locks/UserSpaceReadWriteLock.h"
 
@@ -46,7 +47,9 @@ static int NUM_THREADS = 100;
 static int NUM_OPS = 1000;
 
 static AtomicInteger CLIENTS_RUNNING;
-#ifdef USERSPACE
+#if defined(BIASED)
+static BiasedReadWriteLock LOCK;
+#elif defined(USERSPACE)
 static UserSpaceReadWriteLock LOCK;
 #else
 static ReentrantReadWriteLock LOCK;
@@ -33,6 +33,9 @@
 #include "cxx/lang/Runnable.h"
 
 #include "cxx/util/concurrent/atomic/AtomicInteger.h"
+#include "cxx/util/concurrent/locks/FutexLock.h"
+#include "cxx/util/concurrent/locks/ProfiledLock.h"
+#include "cxx/util/concurrent/locks/QueueLock.h"
 #include "cxx/util/concurrent/locks/UserSpaceLock.h"
 
 using namespace cxx::util::concurrent;
@@ -42,10 +45,20 @@ using namespace cxx::util::concurrent::atomic;
 static int NUM_THREADS = 100;
 
 static AtomicInteger CLIENTS_RUNNING;
-static UserSpaceLock LOCK;
 static boolean FLAG = false;
 
+struct TestLockSite {
+	static const char* name(void) {
+		return "test";
+	}
+};
+
+// XXX: the same contention test is run against each lock implementation (see main)
+template<typename L>
 class TestThread : public Runnable {
+	public:
+		static L LOCK;
+
 	private:
 		int m_num;
 
@@ -112,19 +125,21 @@ class TestThread : public Runnable {
 		}
 };
 
-int main(int argc, char** argv) {
+template<typename L>
+L TestThread<L>::LOCK;
+
+template<typename L>
+void testLock(const char* name) {
 
-	TestThread** clients = new TestThread*[NUM_THREADS];
+	TestThread<L>** clients = new TestThread<L>*[NUM_THREADS];
 	Thread** threads = new Thread*[NUM_THREADS];
 
-	printf("\n -- %d CLIENTs\n\n", NUM_THREADS);
-
-	srand(System::currentTimeMillis());
+	printf("\n -- %s: %d CLIENTs\n\n", name, NUM_THREADS);
 
 	for (int i = 0; i < NUM_THREADS; i++) {
 		CLIENTS_RUNNING.getAndIncrement();
 
-		clients[i] = new TestThread(i);
+		clients[i] = new TestThread<L>(i);
 		threads[i] = new Thread(clients[i]);
 		threads[i]->start();
 	}
@@ -143,6 +158,27 @@ int main(int argc, char** argv) {
 
 	delete [] clients;
 	delete [] threads;
+}
+
+int main(int argc, char** argv) {
+
+	srand(System::currentTimeMillis());
+
+	testLock<UserSpaceLock>("UserSpaceLock");
+	testLock<FutexLock>("FutexLock");
+	testLock<QueueLock>("QueueLock");
+
+	LockProfile::setEnabled(true);
+	testLock<ProfiledLock<FutexLock, TestLockSite> >("ProfiledLock");
+	LockProfile::setEnabled(false);
+
+	LockProfile::Site* site = LockProfile::getSites();
+	if ((site == null) || (site->getAcquisitions() == 0) || (site->getContended() == 0) || (site->getHold(0.50) == 0)) {
+		printf("- FAILED: lock profile\n");
+		exit(-1);
+	}
+
+	printf("\n -- %s: acquired: %llu, contended: %llu, wait p99: %llu ns, hold p50: %llu ns\n", site->getName(), site->getAcquisitions(), site->getContended(), site->getWait(0.99), site->getHold(0.50));
 
 	return 0;
 }
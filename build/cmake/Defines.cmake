@@ -45,6 +45,9 @@ set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DDEEP_USERLOCK")
 # Turn this flag on for io statistic calculation
 #set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DDEEP_IO_STATS")
 
+# Turn this flag on for lock contention statistics (see LockProfile)
+#set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DDEEP_LOCK_STATS")
+
 # Turn this flag on for commit statistic calculation
 #set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DDEEP_COMMIT_STATS")
 